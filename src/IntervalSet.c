@@ -1,39 +1,412 @@
 #include "intervalSet.h"
 // #define DEBUG_PRINT 1
 #include "debug.h"
+#include "intervalKernels.h"
+#include "memArena.h"
 #include <stdlib.h>
+#include <string.h>
 
 /**
- * Function pointer type for Interval comparison functions.
+ * Interval sets shorter than this are counted by a linear scan, since building the index would
+ * cost more than it saves.
  */
-typedef bool (*ComparisonFunc)(const Interval*, const uint32_t);
+#define INTERVAL_SET_INDEX_MIN_LENGTH 16
 
 /**
- * Creates a new IntervalSet object.
+ * The number of bits of the values handled per pass of the radix sort building an index.
+ */
+#define INTERVAL_SET_INDEX_RADIX_BITS 8
+
+/**
+ * Sorted bottom and top values of an IntervalSet, each with the prefix sums of the corresponding
+ * amounts. Allows counting queries by binary search.
+ */
+struct IntervalSetIndex {
+  uint32_t length;        /** The number of entries in each of the arrays. */
+  uint32_t* bottoms;      /** The bottom values in ascending order. */
+  uint32_t* bottomPrefix; /** bottomPrefix[k] is the sum of the amounts of bottoms[0..k-1]. */
+  uint32_t* tops;         /** The top values in ascending order. */
+  uint32_t* topPrefix;    /** topPrefix[k] is the sum of the amounts of tops[0..k-1]. */
+  uint32_t data[];        /** The memory backing the four arrays. */
+};
+
+/**
+ * A value of an interval together with the amount of intervals it stands for.
+ */
+typedef struct ValueAmount {
+  uint32_t value;
+  uint32_t amount;
+} ValueAmount;
+
+/**
+ * Sorts the given values and writes them together with the prefix sums of their amounts into the
+ * given arrays. The values are sorted by a radix sort over their distance from the smallest value,
+ * so this takes linear time.
  *
- * @param intervals An array of Interval objects.
- * @param length The length of the intervals array.
+ * @param values The values to be sorted.
+ * @param amounts The amounts of the values.
+ * @param length The number of values.
+ * @param sortedValues The array to write the sorted values to.
+ * @param prefix The array to write the prefix sums to, needs to have length + 1 entries.
+ * @return True if the arrays have been filled, false if memory allocation fails.
+ */
+static bool fillSortedPrefix(const uint32_t values[], const uint32_t amounts[],
+                             const uint32_t length, uint32_t sortedValues[], uint32_t prefix[]) {
+  const uint32_t mask = (1u << INTERVAL_SET_INDEX_RADIX_BITS) - 1;
+  uint32_t counts[(1u << INTERVAL_SET_INDEX_RADIX_BITS) + 1];
+  ValueAmount* pairs = memAlloc(sizeof(ValueAmount) * 2 * length);
+
+  if (!pairs) {
+    return false;
+  }
+
+  ValueAmount* src = pairs;
+  ValueAmount* dst = pairs + length;
+  uint32_t minValue = UINT32_MAX, maxValue = 0;
+  for (uint32_t k = 0; k < length; k++) {
+    src[k] = (ValueAmount){values[k], amounts[k]};
+    minValue = __min(minValue, values[k]);
+    maxValue = __max(maxValue, values[k]);
+  }
+
+  const uint32_t range = maxValue - minValue;
+  for (uint32_t shift = 0; shift < 32 && (range >> shift) > 0;
+       shift += INTERVAL_SET_INDEX_RADIX_BITS) {
+    memset(counts, 0, sizeof(counts));
+
+    // count the digits, shifted by one so the prefix sums become start positions
+    for (uint32_t k = 0; k < length; k++) {
+      counts[(((src[k].value - minValue) >> shift) & mask) + 1]++;
+    }
+    for (uint32_t d = 1; d <= mask; d++) {
+      counts[d] += counts[d - 1];
+    }
+    for (uint32_t k = 0; k < length; k++) {
+      dst[counts[((src[k].value - minValue) >> shift) & mask]++] = src[k];
+    }
+
+    ValueAmount* tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+
+  prefix[0] = 0;
+  for (uint32_t k = 0; k < length; k++) {
+    sortedValues[k] = src[k].value;
+    prefix[k + 1] = prefix[k] + src[k].amount;
+  }
+
+  memFree(pairs);
+
+  return true;
+}
+
+/**
+ * Builds the prefix-count index of the given IntervalSet. The bottoms of a sorted set are read
+ * back to front in a single pass, all other columns are radix sorted.
+ *
+ * @param intervalSet The IntervalSet to build the index for.
+ * @return A pointer to the newly created index, or NULL if the set is too short to need one or
+ * memory allocation fails.
+ */
+static IntervalSetIndex* intervalSetIndexCreate(const IntervalSet* intervalSet) {
+  const uint32_t length = intervalSet->length;
+
+  if (length < INTERVAL_SET_INDEX_MIN_LENGTH) {
+    return NULL;
+  }
+
+  IntervalSetIndex* index =
+      memAlloc(sizeof(IntervalSetIndex) + sizeof(uint32_t) * (4 * length + 2));
+
+  if (!index) {
+    return NULL;
+  }
+
+  index->length = length;
+  index->bottoms = index->data;
+  index->bottomPrefix = index->bottoms + length;
+  index->tops = index->bottomPrefix + length + 1;
+  index->topPrefix = index->tops + length;
+
+  bool filled;
+  if (intervalSet->sorted) {
+    index->bottomPrefix[0] = 0;
+    for (uint32_t k = 0; k < length; k++) {
+      index->bottoms[k] = intervalSet->bottoms[length - 1 - k];
+      index->bottomPrefix[k + 1] = index->bottomPrefix[k] + intervalSet->amounts[length - 1 - k];
+    }
+    filled = true;
+  } else {
+    filled = fillSortedPrefix(intervalSet->bottoms, intervalSet->amounts, length, index->bottoms,
+                              index->bottomPrefix);
+  }
+
+  if (!filled || !fillSortedPrefix(intervalSet->tops, intervalSet->amounts, length, index->tops,
+                                   index->topPrefix)) {
+    memFree(index);
+    return NULL;
+  }
+
+  return index;
+}
+
+/**
+ * Returns the prefix-count index of the given IntervalSet, building it on the first query, so sets
+ * that are never counted do not pay for it. The columns do not change once a set is finalized, so
+ * the index is a cache and may be added to a const set. Sets shared between threads may build it
+ * concurrently, in which case only the first index published is kept.
+ *
+ * @param intervalSet The IntervalSet to get the index of.
+ * @return The index, or NULL if the set is too short to need one or memory allocation fails.
+ */
+static const IntervalSetIndex* intervalSetGetIndex(const IntervalSet* intervalSet) {
+  if (intervalSet->length < INTERVAL_SET_INDEX_MIN_LENGTH) {
+    return NULL;
+  }
+
+  IntervalSetIndex* index;
+#pragma omp atomic read acquire
+  index = intervalSet->index;
+
+  if (index) {
+    return index;
+  }
+
+  index = intervalSetIndexCreate(intervalSet);
+  if (!index) {
+    return NULL;
+  }
+
+  IntervalSet* cachingSet = (IntervalSet*)intervalSet;
+  IntervalSetIndex* published;
+#pragma omp critical(intervalSetIndex)
+  {
+    published = cachingSet->index;
+    if (!published) {
+#pragma omp atomic write release
+      cachingSet->index = index;
+      published = index;
+    }
+  }
+
+  if (published != index) {
+    memFree(index);
+  }
+
+  return published;
+}
+
+/**
+ * Returns the index of the first entry in the ascending array that is greater than value.
+ *
+ * @param values The ascending array to search in.
+ * @param length The length of the array.
+ * @param value The value to compare against.
+ * @return The index of the first entry greater than value, or length if there is none.
+ */
+static uint32_t upperBound(const uint32_t values[], const uint32_t length, const uint32_t value) {
+  uint32_t low = 0, high = length;
+  while (low < high) {
+    uint32_t mid = low + (high - low) / 2;
+    if (values[mid] <= value) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  return low;
+}
+
+/**
+ * Returns the index of the first entry in the ascending array that is greater than or equal to
+ * value.
+ *
+ * @param values The ascending array to search in.
+ * @param length The length of the array.
+ * @param value The value to compare against.
+ * @return The index of the first entry greater than or equal to value, or length if there is none.
+ */
+static uint32_t lowerBound(const uint32_t values[], const uint32_t length, const uint32_t value) {
+  uint32_t low = 0, high = length;
+  while (low < high) {
+    uint32_t mid = low + (high - low) / 2;
+    if (values[mid] < value) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  return low;
+}
+
+/**
+ * Counts the intervals with a bottom value less than or equal to i using the index.
+ *
+ * @param index The index of the IntervalSet to count intervals from.
+ * @param i The value to compare against.
+ * @return The number of intervals with a bottom value less than or equal to i.
+ */
+static uint32_t indexCountBottomLessEqual(const IntervalSetIndex* index, const uint32_t i) {
+  return index->bottomPrefix[upperBound(index->bottoms, index->length, i)];
+}
+
+/**
+ * Counts the intervals with a top value less than i using the index.
+ *
+ * @param index The index of the IntervalSet to count intervals from.
+ * @param i The value to compare against.
+ * @return The number of intervals with a top value less than i.
+ */
+static uint32_t indexCountTopLess(const IntervalSetIndex* index, const uint32_t i) {
+  return index->topPrefix[lowerBound(index->tops, index->length, i)];
+}
+
+/**
+ * Points the column pointers of the given IntervalSet into its data array.
+ *
+ * @param intervalSet The IntervalSet whose columns should be set.
+ * @param capacity The number of intervals each column has room for.
+ */
+static void intervalSetSetColumns(IntervalSet* intervalSet, const uint32_t capacity) {
+  intervalSet->bottoms = intervalSet->data;
+  intervalSet->tops = intervalSet->bottoms + capacity;
+  intervalSet->amounts = intervalSet->tops + capacity;
+}
+
+/**
+ * The id of the most recently created IntervalSet.
+ */
+static uint32_t lastId = 0;
+
+/**
+ * Returns a new id for an IntervalSet. Ids are dense and never 0, so they can index hash sets
+ * and bitmaps, and unlike addresses they are not reused after a set has been deleted.
+ *
+ * @return The new id.
+ */
+static uint32_t intervalSetNextId(void) {
+  uint32_t id;
+#pragma omp atomic capture
+  id = ++lastId;
+
+  return id;
+}
+
+/**
+ * Allocates the memory of an empty IntervalSet with room for capacity intervals, without a stack
+ * and an id yet. Until they are set, the set may be freed with memFree.
+ *
+ * @param capacity The maximal number of distinct intervals the set will contain.
+ * @return A pointer to the newly allocated IntervalSet object, or NULL if memory allocation
+ * fails.
+ */
+static IntervalSet* intervalSetAllocateColumns(const uint32_t capacity) {
+  IntervalSet* intervalSet = memAlloc(sizeof(IntervalSet) + 3 * sizeof(uint32_t) * capacity);
+
+  if (intervalSet) {
+    intervalSet->length = 0;
+    intervalSet->index = NULL;
+    intervalSetSetColumns(intervalSet, capacity);
+  }
+
+  return intervalSet;
+}
+
+/**
+ * Allocates an empty IntervalSet with room for capacity intervals. The intervals have to be
+ * written into the columns and the set has to be passed to intervalSetFinalize afterwards.
+ *
+ * @param capacity The maximal number of distinct intervals the set will contain.
  * @param stack The Stack object associated with the IntervalSet.
- * @return A pointer to the newly created IntervalSet object, or NULL if memory allocation
+ * @return A pointer to the newly allocated IntervalSet object, or NULL if memory allocation
  * fails.
  */
-static IntervalSet* intervalSetCreate(const Interval intervals[], const uint32_t length,
-                                      const Stack stack) {
-  IntervalSet* intervalSet = malloc(sizeof(IntervalSet) + sizeof(Interval) * length);
+static IntervalSet* intervalSetAllocate(const uint32_t capacity, const Stack stack) {
+  IntervalSet* intervalSet = intervalSetAllocateColumns(capacity);
 
   if (intervalSet) {
     intervalSet->stack = stackCopy(stack);
-    intervalSet->length = length;
+    intervalSet->id = intervalSetNextId();
+  }
+
+  return intervalSet;
+}
+
+/**
+ * Computes the number of intervals, the fingerprint and the sorted flag of the given IntervalSet.
+ *
+ * @param intervalSet The IntervalSet to summarize.
+ */
+static void intervalSetSummarize(IntervalSet* intervalSet) {
+  bool sorted = true;
+  uint32_t nIntervals = 0;
+  IntervalSetFingerprint fingerprint = {
+      .minBottom = intervalSet->length ? UINT32_MAX : 0, .maxBottom = 0, .bottomSum = 0};
+
+  for (uint32_t k = 0; k < intervalSet->length; k++) {
+    const uint32_t bottom = intervalSet->bottoms[k];
+
+    sorted &= k == 0 || intervalSet->bottoms[k - 1] >= bottom;
+    nIntervals += intervalSet->amounts[k];
+    fingerprint.minBottom = __min(fingerprint.minBottom, bottom);
+    fingerprint.maxBottom = __max(fingerprint.maxBottom, bottom);
+    fingerprint.bottomSum += (uint64_t)bottom * intervalSet->amounts[k];
+  }
 
-    // copy the intervals into the new array
-    for (uint32_t i = 0; i < length; i++) {
-      intervalSet->intervals[i] = intervals[i];
+  intervalSet->sorted = sorted;
+  intervalSet->nIntervals = nIntervals;
+  intervalSet->fingerprint = fingerprint;
+}
+
+/**
+ * Finishes the creation of an IntervalSet after its columns have been filled: shrinks the
+ * allocation to the actual length and computes its summary. The index is built on demand.
+ *
+ * @param intervalSet The IntervalSet to finalize.
+ * @param capacity The capacity the set has been allocated with.
+ * @return A pointer to the finalized IntervalSet, which may have moved.
+ */
+static IntervalSet* intervalSetFinalize(IntervalSet* intervalSet, const uint32_t capacity) {
+  const uint32_t length = intervalSet->length;
+
+  if (length < capacity) {
+    // move the columns together, then give back the unused memory
+    memmove(intervalSet->data + length, intervalSet->tops, sizeof(uint32_t) * length);
+    memmove(intervalSet->data + 2 * length, intervalSet->amounts, sizeof(uint32_t) * length);
+
+    IntervalSet* shrunk =
+        memRealloc(intervalSet, sizeof(IntervalSet) + 3 * sizeof(uint32_t) * length);
+    if (shrunk) {
+      intervalSet = shrunk;
     }
+    intervalSetSetColumns(intervalSet, length);
   }
 
+  intervalSetSummarize(intervalSet);
+
   return intervalSet;
 }
 
+/**
+ * Appends an interval to the columns of an IntervalSet that is being built.
+ *
+ * @param intervalSet The IntervalSet to append to.
+ * @param bottom The bottom value of the interval.
+ * @param top The top value of the interval.
+ * @param amount The amount of the interval.
+ */
+static void intervalSetAppend(IntervalSet* intervalSet, const uint32_t bottom, const uint32_t top,
+                              const uint32_t amount) {
+  const uint32_t k = intervalSet->length++;
+
+  intervalSet->bottoms[k] = bottom;
+  intervalSet->tops[k] = top;
+  intervalSet->amounts[k] = amount;
+}
+
 /**
  * Creates a new IntervalSet object.
  *
@@ -43,17 +416,39 @@ static IntervalSet* intervalSetCreate(const Interval intervals[], const uint32_t
  * allocation fails.
  */
 IntervalSet* intervalSetCreateBlank(const Interval intervals[], const uint32_t length) {
-  return intervalSetCreate(intervals, length, NULL);
+  IntervalSet* intervalSet = intervalSetAllocate(length, NULL);
+
+  if (intervalSet) {
+    for (uint32_t k = 0; k < length; k++) {
+      intervalSetAppend(intervalSet, intervals[k].bottom, intervals[k].top, intervals[k].amount);
+    }
+
+    intervalSet = intervalSetFinalize(intervalSet, length);
+  }
+
+  return intervalSet;
+}
+
+/**
+ * Returns the interval at the given position of the IntervalSet.
+ *
+ * @param intervalSet The IntervalSet to read from.
+ * @param k The position of the interval, must be less than the length of the set.
+ * @return The interval at position k.
+ */
+Interval intervalSetGetInterval(const IntervalSet* intervalSet, const uint32_t k) {
+  return (Interval){intervalSet->bottoms[k], intervalSet->tops[k], intervalSet->amounts[k]};
 }
 
 /**
- * Creates a copy of the given IntervalSet.
+ * Returns the columns of the given IntervalSet for use with the interval kernels.
  *
- * @param intervalSet The IntervalSet to be copied.
- * @return A new IntervalSet that is a copy of the original IntervalSet.
+ * @param intervalSet The IntervalSet to get the columns of.
+ * @return The columns of the set.
  */
-static IntervalSet* intervalSetCopy(const IntervalSet* intervalSet) {
-  return intervalSetCreate(intervalSet->intervals, intervalSet->length, intervalSet->stack);
+static IntervalColumns intervalSetGetColumns(const IntervalSet* intervalSet) {
+  return (IntervalColumns){intervalSet->bottoms, intervalSet->tops, intervalSet->amounts,
+                           intervalSet->length};
 }
 
 /**
@@ -64,7 +459,8 @@ static IntervalSet* intervalSetCopy(const IntervalSet* intervalSet) {
 void intervalSetDelete(IntervalSet* intervalSet) {
   if (intervalSet) {
     stackDelete(&(intervalSet->stack));
-    free(intervalSet);
+    memFree(intervalSet->index);
+    memFree(intervalSet);
     intervalSet = NULL;
   }
 }
@@ -76,11 +472,7 @@ void intervalSetDelete(IntervalSet* intervalSet) {
  * @return The number of intervals in the IntervalSet.
  */
 uint32_t intervalSetCountIntervals(const IntervalSet* intervalSet) {
-  uint32_t count = 0;
-  for (uint32_t i = 0; i < intervalSet->length; i++) {
-    count += intervalSet->intervals[i].amount;
-  }
-  return count;
+  return intervalSet->nIntervals;
 }
 
 /**
@@ -93,27 +485,36 @@ uint32_t intervalSetCountIntervals(const IntervalSet* intervalSet) {
  */
 bool intervalSetIsDominatedBy(const IntervalSet* thisSet, const IntervalSet* otherSet) {
   // if the sets are not equally long, no assertion can be made
-  if (intervalSetCountIntervals(thisSet) != intervalSetCountIntervals(otherSet)) {
+  if (thisSet->nIntervals != otherSet->nIntervals) {
+    return false;
+  }
+
+  // a dominating set has all bottoms at most as large, so neither can its extremes or sum be
+  const IntervalSetFingerprint* thisPrint = &(thisSet->fingerprint);
+  const IntervalSetFingerprint* otherPrint = &(otherSet->fingerprint);
+  if (otherPrint->maxBottom > thisPrint->maxBottom ||
+      otherPrint->minBottom > thisPrint->minBottom ||
+      otherPrint->bottomSum > thisPrint->bottomSum) {
     return false;
   }
 
   // I is the index of the current interval, J is the amount of elements that have been compared
   uint32_t thisI = 0, thisJ = 0, otherI = 0, otherJ = 0;
   while (thisI < thisSet->length) {
-    if (!(otherSet->intervals[otherI].bottom <= thisSet->intervals[thisI].bottom)) {
+    if (!(otherSet->bottoms[otherI] <= thisSet->bottoms[thisI])) {
       return false;
     }
 
     // get the minimum of the two amounts, to skip equal comparisons
-    uint32_t minAmount = __min(thisSet->intervals[thisI].amount - thisJ,
-                               otherSet->intervals[otherI].amount - otherJ);
+    uint32_t minAmount =
+        __min(thisSet->amounts[thisI] - thisJ, otherSet->amounts[otherI] - otherJ);
     thisJ += minAmount;
     otherJ += minAmount;
-    if (thisJ == thisSet->intervals[thisI].amount) {
+    if (thisJ == thisSet->amounts[thisI]) {
       thisI++;
       thisJ = 0;
     }
-    if (otherJ == otherSet->intervals[otherI].amount) {
+    if (otherJ == otherSet->amounts[otherI]) {
       otherI++;
       otherJ = 0;
     }
@@ -123,72 +524,186 @@ bool intervalSetIsDominatedBy(const IntervalSet* thisSet, const IntervalSet* oth
 }
 
 /**
- * Swaps two Interval objects.
+ * The number of bits of the sort key handled per pass of the radix sort, if the keys are too
+ * spread out for a single counting sort pass.
+ */
+#define RADIX_BITS 8
+
+/**
+ * Returns the sort key of a value, its distance from the base value in the sort direction.
  *
- * @param a Pointer to the first Interval object.
- * @param b Pointer to the second Interval object.
+ * @param value The value to compute the key of.
+ * @param base The smallest value when sorting ascending, the largest one when sorting descending.
+ * @param descending Whether larger values should come first.
+ * @return The sort key of the value.
  */
-static void swap(Interval* a, Interval* b) {
-  Interval tmp = *a;
-  *a = *b;
-  *b = tmp;
+static inline uint32_t sortKey(const uint32_t value, const uint32_t base, const bool descending) {
+  return descending ? base - value : value - base;
 }
 
 /**
- * Performs heapify operation on an array of Interval objects.
+ * Performs one stable counting sort pass over the intervals, ordered by the digit
+ * (sortKey(value) >> shift) & mask of the given column.
  *
- * @param intervals The array of Interval objects.
- * @param n The size of the array.
- * @param i The index of the current element.
+ * @param src The columns to read the intervals from (bottoms, tops, amounts).
+ * @param dst The columns to write the sorted intervals to.
+ * @param length The number of intervals.
+ * @param column The column to sort by, 0 for the bottoms and 1 for the tops.
+ * @param base The base value of the sort keys.
+ * @param descending Whether larger values should come first.
+ * @param shift The position of the digit within the key.
+ * @param mask The mask of the digit, one less than the number of buckets.
+ * @param counts Scratch array with mask + 2 entries.
  */
-static void heapify(Interval intervals[], const uint32_t n, const uint32_t i) {
-  uint32_t smallest = i;
-  uint32_t left = 2 * i + 1;
-  uint32_t right = 2 * i + 2;
+static void countingSortPass(uint32_t* src[3], uint32_t* dst[3], const uint32_t length,
+                             const uint32_t column, const uint32_t base, const bool descending,
+                             const uint32_t shift, const uint32_t mask, uint32_t counts[]) {
+  for (uint32_t d = 0; d <= mask + 1; d++) {
+    counts[d] = 0;
+  }
 
-  // check if one of the two successors is bigger
-  if (left < n && intervals[left].bottom < intervals[smallest].bottom) {
-    smallest = left;
+  // count the digits, shifted by one so the prefix sums become start positions
+  for (uint32_t k = 0; k < length; k++) {
+    counts[((sortKey(src[column][k], base, descending) >> shift) & mask) + 1]++;
   }
 
-  if (right < n && intervals[right].bottom < intervals[smallest].bottom) {
-    smallest = right;
+  for (uint32_t d = 1; d <= mask + 1; d++) {
+    counts[d] += counts[d - 1];
   }
 
-  // if the left or right was bigger
-  if (smallest != i) {
-    swap(&intervals[i], &intervals[smallest]);
-    heapify(intervals, n, smallest);
+  for (uint32_t k = 0; k < length; k++) {
+    uint32_t pos = counts[(sortKey(src[column][k], base, descending) >> shift) & mask]++;
+    dst[0][pos] = src[0][k];
+    dst[1][pos] = src[1][k];
+    dst[2][pos] = src[2][k];
   }
 }
 
 /**
- * Sorts an array of Interval structs using the heap sort algorithm.
+ * Stably sorts the intervals in the given IntervalSet by one of its columns. This is a counting
+ * sort over the range of the values, or a radix sort if the range is large compared to the length
+ * of the set.
  *
- * @param intervals The array of Interval structs to be sorted.
- * @param n The number of elements in the array.
+ * @param intervalSet The IntervalSet to be sorted.
+ * @param column The column to sort by, 0 for the bottoms and 1 for the tops.
+ * @param minValue The smallest value in the column.
+ * @param maxValue The largest value in the column.
+ * @param descending Whether larger values should come first.
  */
-static void heapSort(Interval intervals[], const uint32_t n) {
-  // go over all nodes that are not leaves (turns array into heap)
-  for (int32_t i = n / 2 - 1; i >= 0; i--) {
-    heapify(intervals, n, i);
+static void intervalSetRadixSort(IntervalSet* intervalSet, const uint32_t column,
+                                 const uint32_t minValue, const uint32_t maxValue,
+                                 const bool descending) {
+  const uint32_t length = intervalSet->length;
+  const uint32_t base = descending ? maxValue : minValue;
+  const uint32_t range = maxValue - minValue;
+
+  // all keys are equal, so a stable sort leaves the intervals in place
+  if (range == 0) {
+    return;
+  }
+
+  // the number of bits needed for the keys
+  uint32_t keyBits = 0;
+  while (keyBits < 32 && (range >> keyBits) > 0) {
+    keyBits++;
   }
 
-  // successively remove all leaves from back to front
-  for (int32_t i = n - 1; i >= 0; i--) {
-    swap(&intervals[0], &intervals[i]);
-    heapify(intervals, i, 0);
+  // one pass over all key bits if the buckets are not much more than the intervals
+  const uint32_t digitBits =
+      keyBits <= 2 * RADIX_BITS && (1u << keyBits) <= 4 * length + 1024 ? keyBits : RADIX_BITS;
+  const uint32_t mask = (1u << digitBits) - 1;
+
+  uint32_t* scratch = malloc(sizeof(uint32_t) * 3 * length);
+  uint32_t* counts = malloc(sizeof(uint32_t) * (mask + 2));
+
+  uint32_t* src[3] = {intervalSet->bottoms, intervalSet->tops, intervalSet->amounts};
+  uint32_t* dst[3] = {scratch, scratch + length, scratch + 2 * length};
+
+  for (uint32_t shift = 0; shift < keyBits; shift += digitBits) {
+    countingSortPass(src, dst, length, column, base, descending, shift, mask, counts);
+
+    for (uint32_t c = 0; c < 3; c++) {
+      uint32_t* tmp = src[c];
+      src[c] = dst[c];
+      dst[c] = tmp;
+    }
   }
+
+  // after an odd number of passes the sorted intervals are in the scratch array
+  if (src[0] != intervalSet->bottoms) {
+    memcpy(intervalSet->bottoms, src[0], sizeof(uint32_t) * length);
+    memcpy(intervalSet->tops, src[1], sizeof(uint32_t) * length);
+    memcpy(intervalSet->amounts, src[2], sizeof(uint32_t) * length);
+  }
+
+  free(scratch);
+  free(counts);
 }
 
 /**
- * Sorts the intervals in the given IntervalSet by their bottom values in descending
- * order.
+ * Sorts the intervals in the given IntervalSet by their bottom values in descending order. Since
+ * bottoms are bounded by the number of intervals, this is a counting sort over the range of the
+ * bottoms, or a radix sort if the range is large compared to the length of the set. The sort is
+ * stable and sets that are already sorted are left untouched.
  *
  * @param intervalSet The IntervalSet to be sorted.
  */
 void intervalSetSortByBottom(IntervalSet* intervalSet) {
-  heapSort(intervalSet->intervals, intervalSet->length);
+  if (intervalSet->sorted) {
+    return;
+  }
+
+  intervalSetRadixSort(intervalSet, 0, intervalSet->fingerprint.minBottom,
+                       intervalSet->fingerprint.maxBottom, true);
+
+  intervalSet->sorted = true;
+}
+
+/**
+ * Brings the given IntervalSet into its canonical form: the intervals are sorted by descending
+ * bottom and ascending top, and intervals with equal bottom and top are merged into a single entry
+ * carrying the summed amount. The multiset of intervals, and thereby every count, is unchanged.
+ *
+ * @param intervalSet The IntervalSet to be normalized.
+ */
+void intervalSetNormalize(IntervalSet* intervalSet) {
+  const uint32_t length = intervalSet->length;
+
+  if (length < 2) {
+    return;
+  }
+
+  uint32_t minTop = UINT32_MAX, maxTop = 0;
+  for (uint32_t k = 0; k < length; k++) {
+    minTop = __min(minTop, intervalSet->tops[k]);
+    maxTop = __max(maxTop, intervalSet->tops[k]);
+  }
+
+  // sorting by top first and stably by bottom afterwards puts equal intervals next to each other
+  intervalSetRadixSort(intervalSet, 1, minTop, maxTop, false);
+  intervalSetRadixSort(intervalSet, 0, intervalSet->fingerprint.minBottom,
+                       intervalSet->fingerprint.maxBottom, true);
+
+  uint32_t merged = 0;
+  for (uint32_t k = 1; k < length; k++) {
+    if (intervalSet->bottoms[k] == intervalSet->bottoms[merged] &&
+        intervalSet->tops[k] == intervalSet->tops[merged]) {
+      intervalSet->amounts[merged] += intervalSet->amounts[k];
+    } else {
+      merged++;
+      intervalSet->bottoms[merged] = intervalSet->bottoms[k];
+      intervalSet->tops[merged] = intervalSet->tops[k];
+      intervalSet->amounts[merged] = intervalSet->amounts[k];
+    }
+  }
+  intervalSet->length = merged + 1;
+
+  // the columns keep their capacity, only the summary and the index need to be rebuilt. The index
+  // is built right away, since the input set is normalized outside of the arena of the run and a
+  // lazily built index would be allocated from it
+  memFree(intervalSet->index);
+  intervalSetSummarize(intervalSet);
+  intervalSet->index = intervalSetIndexCreate(intervalSet);
 }
 
 /**
@@ -201,32 +716,61 @@ void intervalSetPrint(const IntervalSet* intervalSet) {
     debug_print("[]");
   } else
     for (uint32_t i = 0; i < intervalSet->length; i++) {
-      debug_print("[%d, %d, %d], ", intervalSet->intervals[i].bottom, intervalSet->intervals[i].top,
-                  intervalSet->intervals[i].amount);
+      debug_print("[%d, %d, %d], ", intervalSet->bottoms[i], intervalSet->tops[i],
+                  intervalSet->amounts[i]);
     }
 
   debug_print("\n");
 }
 
 /**
- * Counts the number of intervals in the given IntervalSet that satisfy the comparison function.
+ * Counts the number of intervals in the given IntervalSet that lie inside the box.
  *
  * @param intervalSet The IntervalSet to count intervals from.
- * @param i The value to compare intervals with.
- * @param compFunc The comparison function used to compare intervals with the value.
- * @return The number of intervals that satisfy the comparison function.
+ * @param box The box the intervals have to lie in.
+ * @return The number of intervals inside the box.
  */
-static uint32_t intervalSetCount(const IntervalSet* intervalSet, const uint32_t i,
-                                 ComparisonFunc compFunc) {
-  uint32_t count = 0;
+static uint32_t intervalSetCountBox(const IntervalSet* intervalSet, const IntervalBox box) {
+  IntervalColumns columns = intervalSetGetColumns(intervalSet);
 
-  for (uint32_t j = 0; j < intervalSet->length; j++) {
-    if (compFunc(&(intervalSet->intervals[j]), i)) {
-      count += intervalSet->intervals[j].amount;
-    }
-  }
+  return intervalKernelCountBox(&columns, box);
+}
+
+/**
+ * Returns the box of all intervals with a bottom value greater than i.
+ *
+ * @param i The value to compare against.
+ * @return The box of the intervals greater than i.
+ */
+static IntervalBox boxGreaterI(const uint32_t i) {
+  IntervalBox box = intervalBoxAll();
+  box.minBottom = i + 1;
+  return box;
+}
+
+/**
+ * Returns the box of all intervals containing i.
+ *
+ * @param i The value the intervals have to contain.
+ * @return The box of the intervals containing i.
+ */
+static IntervalBox boxContainingI(const uint32_t i) {
+  IntervalBox box = intervalBoxAll();
+  box.maxBottom = i;
+  box.minTop = i;
+  return box;
+}
 
-  return count;
+/**
+ * Returns the box of all intervals with a top value greater than or equal to i.
+ *
+ * @param i The value to compare against.
+ * @return The box of the intervals greater than or equal to i.
+ */
+static IntervalBox boxGreaterEqualI(const uint32_t i) {
+  IntervalBox box = intervalBoxAll();
+  box.minTop = i;
+  return box;
 }
 
 /**
@@ -238,7 +782,12 @@ static uint32_t intervalSetCount(const IntervalSet* intervalSet, const uint32_t
  * @return The count of intervals greater than the specified value.
  */
 uint32_t intervalSetCountGreaterI(const IntervalSet* intervalSet, const uint32_t i) {
-  return intervalSetCount(intervalSet, i, intervalGreaterThan);
+  const IntervalSetIndex* index = intervalSetGetIndex(intervalSet);
+  if (index) {
+    return index->bottomPrefix[index->length] - indexCountBottomLessEqual(index, i);
+  }
+
+  return intervalSetCountBox(intervalSet, boxGreaterI(i));
 }
 
 /**
@@ -250,7 +799,14 @@ uint32_t intervalSetCountGreaterI(const IntervalSet* intervalSet, const uint32_t
  * @return The count of intervals containing the specified value.
  */
 uint32_t intervalSetCountContainingI(const IntervalSet* intervalSet, const uint32_t i) {
-  return intervalSetCount(intervalSet, i, intervalContains);
+  // every interval with a top below i also has a bottom below i, so the containing ones are
+  // exactly those with bottom <= i minus those with top < i
+  const IntervalSetIndex* index = intervalSetGetIndex(intervalSet);
+  if (index) {
+    return indexCountBottomLessEqual(index, i) - indexCountTopLess(index, i);
+  }
+
+  return intervalSetCountBox(intervalSet, boxContainingI(i));
 }
 
 /**
@@ -262,234 +818,301 @@ uint32_t intervalSetCountContainingI(const IntervalSet* intervalSet, const uint3
  * @return The count of intervals that are greater than or equal to the specified value.
  */
 static uint32_t intervalSetCountGreaterEqualI(const IntervalSet* intervalSet, const uint32_t i) {
-  return intervalSetCount(intervalSet, i, intervalGreaterEqual);
+  const IntervalSetIndex* index = intervalSetGetIndex(intervalSet);
+  if (index) {
+    return index->topPrefix[index->length] - indexCountTopLess(index, i);
+  }
+
+  return intervalSetCountBox(intervalSet, boxGreaterEqualI(i));
 }
 
 /**
- * Frees an array of intervals.
+ * Creates a view onto the whole given IntervalSet.
  *
- * @param intervals The Interval-array to free.
+ * @param intervalSet The IntervalSet to be viewed.
+ * @return A view exposing every interval of the set.
  */
-static void freeIntervals(Interval intervals[]) {
-  free(intervals);
-  intervals = NULL;
+IntervalSetView intervalSetViewWhole(const IntervalSet* intervalSet) {
+  return (IntervalSetView){
+      .base = intervalSet, .topBelow = UINT32_MAX, .minBottom = 0, .minTop = 0, .inverse = false};
 }
 
 /**
- * Returns the first interval in the given interval set that contains the specified value.
+ * Checks whether the filter of the given view is the identity, i.e. the view exposes the whole
+ * set or, if it is inverted, nothing at all.
  *
- * @param intervalSet The interval set to search in.
- * @param i The value to search for.
- * @return A pointer to the first interval that contains the specified value, or NULL if
- * no such interval is found.
+ * @param view The view to check.
+ * @return true if the filter selects every interval, false otherwise.
  */
-static Interval* intervalSetGetFirstContainingI(IntervalSet* intervalSet, const uint32_t i) {
-  for (uint32_t j = 0; j < intervalSet->length; j++) {
-    if (intervalContains(&(intervalSet->intervals[j]), i)) {
-      return &(intervalSet->intervals[j]);
-    }
-  }
+static bool intervalSetViewIsUnfiltered(const IntervalSetView* view) {
+  return view->topBelow == UINT32_MAX && view->minBottom == 0 && view->minTop == 0;
+}
 
-  return NULL;
+/**
+ * Returns the box of the intervals matching the filter of the given view.
+ *
+ * @param view The view to get the filter box of.
+ * @return The box of the intervals matching the filter, ignoring whether the view is inverted.
+ */
+static IntervalBox intervalSetViewFilterBox(const IntervalSetView* view) {
+  IntervalBox box = intervalBoxAll();
+  box.minBottom = view->minBottom;
+  box.minTop = view->minTop;
+  box.maxTop = view->topBelow == UINT32_MAX ? UINT32_MAX : view->topBelow - 1;
+  return box;
 }
 
 /**
- * Removes the first 'g' intervals that include 'i' from the given 'intervalSet' and
- * returns a new IntervalSet.
+ * Checks whether the interval at the given position of the viewed set is exposed by the view.
  *
- * @param intervalSet The original IntervalSet from which intervals will be removed.
- * @param i The number the intervals must include.
- * @param g The number of intervals to be removed from the beginning of the IntervalSet.
- * @return A new IntervalSet without the first 'g' intervals that include 'i'.
+ * @param view The view to check against.
+ * @param k The position of the interval in the viewed set.
+ * @return true if the interval is part of the view, false otherwise.
  */
-IntervalSet* intervalSetGetWithoutFirstGIncludingI(const IntervalSet* intervalSet, const uint32_t i,
-                                                   const uint32_t g) {
-  Interval* intervals = malloc(sizeof(Interval) * intervalSet->length);
+static bool intervalSetViewSelects(const IntervalSetView* view, const uint32_t k) {
+  const IntervalSet* intervalSet = view->base;
+  bool matchesFilter = intervalSet->tops[k] < view->topBelow &&
+                       intervalSet->bottoms[k] >= view->minBottom &&
+                       intervalSet->tops[k] >= view->minTop;
 
-  // counts the number of interval-objects that have been added to the new set
-  int32_t lengthCounter = -1;
+  return matchesFilter != view->inverse;
+}
 
-  uint32_t nAssigned = 0;
-  for (uint32_t outerK = 0; outerK < intervalSet->length; outerK++) {
-    // computed once, since it is the same for all intervals in the outer loop
-    const Interval* currInterval = &(intervalSet->intervals[outerK]);
-    bool intervalContainsI = intervalContains(currInterval, i);
-    bool hasBeenAdded = false;
-
-    for (uint32_t innerK = 0; innerK < currInterval->amount; innerK++) {
-      if (nAssigned < g && intervalContainsI) {
-        nAssigned++;
-      } else if (hasBeenAdded) {
-        // if the interval has already been added to the new set, just increment the amount
-        intervals[lengthCounter].amount++;
-      } else {
-        // if the interval has not been added to the new set yet, add it now
-        intervals[++lengthCounter] = *currInterval;
-        intervals[lengthCounter].amount = 1;
-        hasBeenAdded = true;
-      }
-    }
+/**
+ * Counts the number of intervals in the given view that lie inside the box.
+ *
+ * @param view The view to count intervals from.
+ * @param box The box the intervals have to lie in.
+ * @return The number of intervals of the view inside the box.
+ */
+static uint32_t intervalSetViewCountBox(const IntervalSetView* view, const IntervalBox box) {
+  if (intervalSetViewIsUnfiltered(view)) {
+    return view->inverse ? 0 : intervalSetCountBox(view->base, box);
   }
 
-  IntervalSet* res = intervalSetCreate(intervals, lengthCounter + 1, intervalSet->stack);
+  IntervalBox filteredBox = intervalBoxIntersect(box, intervalSetViewFilterBox(view));
+  uint32_t nMatching = intervalSetCountBox(view->base, filteredBox);
 
-  freeIntervals(intervals);
-
-  return res;
+  // the inverse view contains everything inside the box that does not match the filter
+  return view->inverse ? intervalSetCountBox(view->base, box) - nMatching : nMatching;
 }
 
 /**
- * Retrieves the intervals from the given intervalSet that are right of i and have a
- * bottom value greater than or equal to b.
+ * Counts the number of intervals in the given view that are greater than the specified value.
  *
- * @param intervalSet The intervalSet to retrieve the intervals from.
- * @param i The value the intervals must be right of.
- * @param b The value the intervals must have a greater or equal bottom value than.
- * @return A new IntervalSet containing the retrieved intervals.
+ * @param view The view to search in.
+ * @param i The value to compare against.
+ * @return The count of intervals greater than the specified value.
  */
-static IntervalSet* getRightOfIUnderB(const IntervalSet* intervalSet, const uint32_t i,
-                                      const uint32_t b) {
-  // choosing intervalSet.length as upper bound
-  Interval* intervals = malloc(sizeof(Interval) * intervalSet->length);
-
-  uint32_t nChosen = 0;
-  for (uint32_t j = 0; j < intervalSet->length; j++) {
-    const Interval* currInterval = &(intervalSet->intervals[j]);
-    if (intervalLessThan(currInterval, i) && currInterval->bottom >= b) {
-      intervals[nChosen++] = *currInterval;
-    }
+uint32_t intervalSetViewCountGreaterI(const IntervalSetView* view, const uint32_t i) {
+  if (intervalSetViewIsUnfiltered(view)) {
+    return view->inverse ? 0 : intervalSetCountGreaterI(view->base, i);
   }
 
-  IntervalSet* res = intervalSetCreate(intervals, nChosen, intervalSet->stack);
-
-  freeIntervals(intervals);
-
-  return res;
+  return intervalSetViewCountBox(view, boxGreaterI(i));
 }
 
 /**
- * Retrieves the lowest part of the given interval set.
+ * Counts the number of intervals in the given view that contain the specified value.
  *
- * @param intervalSet The interval set to retrieve the lowest part from.
- * @return The lowest part of the interval set.
+ * @param view The view to search in.
+ * @param i The value to check for containment.
+ * @return The count of intervals containing the specified value.
  */
-IntervalSet* intervalSetGetLowestPart(IntervalSet* intervalSet) {
-  GraphNode* predNode = stackTop(&(intervalSet->stack));
-
-  // if there is no predecessor, return a copy of the interval set
-  if (!predNode) {
-    return intervalSetCopy(intervalSet);
+uint32_t intervalSetViewCountContainingI(const IntervalSetView* view, const uint32_t i) {
+  if (intervalSetViewIsUnfiltered(view)) {
+    return view->inverse ? 0 : intervalSetCountContainingI(view->base, i);
   }
 
-  // check if there is an Interval that intervalContains i
-  Interval* interval = intervalSetGetFirstContainingI(intervalSet, predNode->i);
-
-  return getRightOfIUnderB(intervalSet, predNode->i, interval ? interval->bottom : 0);
+  return intervalSetViewCountBox(view, boxContainingI(i));
 }
 
 /**
- * Counts the number of intervals in the given `intervalSet` that satisfy the following conditions:
- * - The interval's index is less than `i`.
- * - The interval's bottom value is greater than or equal to `b`.
- * - The interval's index is greater than or equal to `j`.
+ * Removes the first 'g' intervals that include 'i' from the given view and returns the remaining
+ * intervals of the view as a new IntervalSet with the stack of the viewed set.
  *
- * @param intervalSet The interval set to search in.
- * @param i           The upper limit index.
- * @param b           The lower limit bottom value.
- * @param j           The lower limit index.
- * @return            The count of intervals that meet the specified conditions.
+ * @param view The view from which intervals will be removed.
+ * @param i The number the intervals must include.
+ * @param g The number of intervals to be removed from the beginning of the view.
+ * @return A new IntervalSet without the first 'g' intervals that include 'i'.
  */
-static uint32_t countRightOfIUnderBGreaterEqualJ(const IntervalSet* intervalSet, const uint32_t i,
-                                                 const uint32_t b, const uint32_t j) {
-  uint32_t nChosen = 0;
-  for (uint32_t k = 0; k < intervalSet->length; k++) {
-    const Interval* currInterval = &(intervalSet->intervals[k]);
-    if (intervalLessThan(currInterval, i) && currInterval->bottom >= b &&
-        intervalGreaterEqual(currInterval, j)) {
-      nChosen += currInterval->amount;
+IntervalSet* intervalSetGetWithoutFirstGIncludingI(const IntervalSetView* view, const uint32_t i,
+                                                   const uint32_t g) {
+  const IntervalSet* intervalSet = view->base;
+  IntervalSet* res = intervalSetAllocate(intervalSet->length, intervalSet->stack);
+
+  if (!res) {
+    return NULL;
+  }
+
+  uint32_t nAssigned = 0;
+  for (uint32_t outerK = 0; outerK < intervalSet->length; outerK++) {
+    if (!intervalSetViewSelects(view, outerK)) {
+      continue;
+    }
+
+    const uint32_t bottom = intervalSet->bottoms[outerK];
+    const uint32_t top = intervalSet->tops[outerK];
+    uint32_t amount = intervalSet->amounts[outerK];
+
+    // take as many of the equal intervals as are still needed, the rest is kept as one entry
+    if (bottom <= i && i <= top) {
+      const uint32_t nTaken = __min(g - nAssigned, amount);
+      nAssigned += nTaken;
+      amount -= nTaken;
+    }
+
+    if (amount > 0) {
+      intervalSetAppend(res, bottom, top, amount);
     }
   }
 
-  return nChosen;
+  return intervalSetFinalize(res, intervalSet->length);
 }
 
 /**
- * Retrieves the lowest part of the IntervalSet that is greater than or equal to a given value.
+ * Retrieves the lowest part of the given interval set, i.e. the intervals that are right of the
+ * i-value of the top of its stack and have a bottom value greater than or equal to the bottom of
+ * the first interval containing that i-value.
  *
- * @param intervalSet The IntervalSet to search in.
- * @param j The value to compare against.
- * @return A pointer to the IntervalSet containing the lowest part greater than or equal to j.
- *         If no such IntervalSet exists, a copy of the original IntervalSet is returned.
+ * @param intervalSet The interval set to retrieve the lowest part from.
+ * @return A view onto the lowest part of the interval set.
  */
-uint32_t intervalSetCountLowestPartGreaterEqualJ(IntervalSet* intervalSet, const uint32_t j) {
+IntervalSetView intervalSetGetLowestPart(const IntervalSet* intervalSet) {
+  IntervalSetView view = intervalSetViewWhole(intervalSet);
   GraphNode* predNode = stackTop(&(intervalSet->stack));
 
-  // if there is no predecessor, return a copy of the interval set
+  // if there is no predecessor, the whole interval set is the lowest part
   if (!predNode) {
-    return intervalSetCountGreaterEqualI(intervalSet, j);
+    return view;
   }
 
   // check if there is an Interval that intervalContains i
-  Interval* interval = intervalSetGetFirstContainingI(intervalSet, predNode->i);
+  IntervalColumns columns = intervalSetGetColumns(intervalSet);
+  uint32_t first = intervalKernelFindFirstInBox(&columns, boxContainingI(predNode->i));
 
-  return countRightOfIUnderBGreaterEqualJ(intervalSet, predNode->i, interval ? interval->bottom : 0,
-                                          j);
+  view.topBelow = predNode->i;
+  view.minBottom = first < intervalSet->length ? intervalSet->bottoms[first] : 0;
+
+  return view;
 }
 
 /**
- * Retrieves a new IntervalSet containing intervals from the given IntervalSet
- * that DON'T satisfy the following conditions:
- * - The interval's bottom is greater than or equal to 'b'.
- * - The interval's index is greater than or equal to 'j'.
- * - The interval's index is less than 'i'.
+ * Builds the group of size g from the lowest part of the given interval set in a single pass, with
+ * the same outcome as counting on intervalSetGetLowestPart and then calling
+ * intervalSetGetWithoutFirstGIncludingI on it. The pass stops at the first interval of the lowest
+ * part that lies above g, and the stack and id are only set once the group has been built.
  *
- * @param intervalSet The original IntervalSet.
- * @param i           The upper bound index.
- * @param b           The lower bound value.
- * @param j           The lower bound index.
- * @return            A new IntervalSet containing the desired intervals.
+ * @param intervalSet The interval set to build the group from.
+ * @param g The size of the group, i.e. the number of intervals containing g to be removed.
+ * @param status Set to the outcome. Failing memory allocation counts as an invalid group.
+ * @return The remaining intervals of the lowest part as a new IntervalSet with the stack of the
+ * given set, or NULL if the group cannot be built.
  */
-static IntervalSet* getInverseRightOfIUnderBGreaterEqualJ(const IntervalSet* intervalSet,
-                                                          const uint32_t i, const uint32_t b,
-                                                          const uint32_t j) {
-  // choosing intervalSet.length as upper bound
-  Interval* intervals = malloc(sizeof(Interval) * intervalSet->length);
+IntervalSet* intervalSetAssignLowestPart(const IntervalSet* intervalSet, const uint32_t g,
+                                         IntervalSetAssignStatus* status) {
+  GraphNode* predNode = stackTop(&(intervalSet->stack));
+
+  // if there is no predecessor, the whole interval set is the lowest part
+  const uint32_t topBelow = predNode ? predNode->i : UINT32_MAX;
+
+  // the lowest part starts at the bottom of the first interval containing the i-value of the
+  // predecessor. In a set sorted by descending bottom, all intervals before that one have a
+  // bottom at least as large, so the bound can be found during the pass itself
+  uint32_t minBottom = 0;
+  bool minBottomFound = !predNode;
+  if (predNode && !intervalSet->sorted) {
+    minBottom = intervalSetGetLowestPart(intervalSet).minBottom;
+    minBottomFound = true;
+  }
+
+  IntervalSet* res = intervalSetAllocateColumns(intervalSet->length);
+  if (!res) {
+    *status = INTERVAL_SET_ASSIGN_INVALID;
+    return NULL;
+  }
 
-  uint32_t nChosen = 0;
+  uint32_t nAssigned = 0;
   for (uint32_t k = 0; k < intervalSet->length; k++) {
-    const Interval* currInterval = &(intervalSet->intervals[k]);
-    if (!(intervalLessThan(currInterval, i) && currInterval->bottom >= b &&
-          intervalGreaterEqual(currInterval, j))) {
-      intervals[nChosen++] = *currInterval;
+    const uint32_t bottom = intervalSet->bottoms[k];
+    const uint32_t top = intervalSet->tops[k];
+    uint32_t amount = intervalSet->amounts[k];
+
+    if (!minBottomFound && bottom <= topBelow && topBelow <= top) {
+      minBottom = bottom;
+      minBottomFound = true;
     }
+
+    if (top >= topBelow || bottom < minBottom) {
+      continue;
+    }
+
+    if (bottom > g) {
+      memFree(res);
+      *status = INTERVAL_SET_ASSIGN_INVALID;
+      return NULL;
+    }
+
+    // take as many of the equal intervals as are still needed, the rest is kept as one entry
+    if (g <= top) {
+      const uint32_t nTaken = __min(g - nAssigned, amount);
+      nAssigned += nTaken;
+      amount -= nTaken;
+    }
+
+    if (amount > 0) {
+      intervalSetAppend(res, bottom, top, amount);
+    }
+  }
+
+  if (nAssigned < g) {
+    memFree(res);
+    *status = INTERVAL_SET_ASSIGN_TOO_FEW;
+    return NULL;
   }
 
-  IntervalSet* res = intervalSetCreate(intervals, nChosen, intervalSet->stack);
+  res->stack = stackCopy(intervalSet->stack);
+  res->id = intervalSetNextId();
+  *status = INTERVAL_SET_ASSIGNED;
+
+  return intervalSetFinalize(res, intervalSet->length);
+}
+
+/**
+ * Counts the number of intervals in the lowest part of the given interval set that are greater
+ * than or equal to j.
+ *
+ * @param intervalSet The IntervalSet to search in.
+ * @param j The value to compare against.
+ * @return The number of intervals in the lowest part that are greater than or equal to j.
+ */
+uint32_t intervalSetCountLowestPartGreaterEqualJ(const IntervalSet* intervalSet, const uint32_t j) {
+  IntervalSetView lowestPart = intervalSetGetLowestPart(intervalSet);
 
-  freeIntervals(intervals);
+  if (intervalSetViewIsUnfiltered(&lowestPart)) {
+    return intervalSetCountGreaterEqualI(intervalSet, j);
+  }
 
-  return res;
+  return intervalSetViewCountBox(&lowestPart, boxGreaterEqualI(j));
 }
 
 /**
- * Retrieves the inverse of the lowest part greater than or equal to j from the given interval set.
+ * Retrieves the inverse of the lowest part greater than or equal to j from the given interval set,
+ * i.e. all intervals that are not counted by intervalSetCountLowestPartGreaterEqualJ.
  *
  * @param intervalSet The interval set to retrieve the inverse of.
  * @param j The value to compare against the lowest part of the intervals.
- * @return The resulting interval set containing the inverse.
+ * @return A view onto the inverse. If the stack is empty, the view is empty.
  */
-IntervalSet* intervalSetGetInverseLowestPartGreaterEqualJ(IntervalSet* intervalSet,
-                                                          const uint32_t j) {
-  GraphNode* predNode = stackTop(&(intervalSet->stack));
+IntervalSetView intervalSetGetInverseLowestPartGreaterEqualJ(const IntervalSet* intervalSet,
+                                                             const uint32_t j) {
+  IntervalSetView view = intervalSetGetLowestPart(intervalSet);
 
-  // if there is no predecessor, return an empty interval set
-  if (!predNode) {
-    return intervalSetCreateBlank(NULL, 0);
+  // if there is no predecessor, the whole set is the lowest part, so the inverse stays empty
+  if (!intervalSetViewIsUnfiltered(&view)) {
+    view.minTop = j;
   }
+  view.inverse = true;
 
-  // check if there is an Interval that intervalContains i
-  Interval* interval = intervalSetGetFirstContainingI(intervalSet, predNode->i);
-
-  return getInverseRightOfIUnderBGreaterEqualJ(intervalSet, predNode->i,
-                                               interval ? interval->bottom : 0, j);
-}
\ No newline at end of file
+  return view;
+}
@@ -3,10 +3,28 @@
 
 #include "graphNode.h"
 #include "jsonPrinter.h"
+#include <stdbool.h>
 #include <stdlib.h>
 
+/**
+ * @brief Options changing how the bad memory algorithm runs, without changing its decision.
+ */
+typedef struct BadMemAlgOptions {
+  bool releaseMarks; /**< Free the marks of a node as soon as it is finished, only in the breadth
+                          first engines. Lowers the peak memory, the marks are still counted. */
+  bool solveOnly;    /**< Only decide whether there is a solution. The breadth first engines stop
+                          as soon as a node (i, n) holds a set, and no metrics are computed. */
+  bool visitByKey;   /**< Visit the sets of a predecessor by descending key instead of newest
+                          first, only in the breadth first engines. Changes the metrics, see
+                          badMemAlgFinishNode. */
+} BadMemAlgOptions;
+
+void badMemAlgSetOptions(const BadMemAlgOptions options);
+BadMemAlgOptions badMemAlgGetOptions(void);
 RunInfo badMemoryAlgorithm(IntervalSet* inputIntervalSet);
 RunInfo badMemoryDepthFirst(IntervalSet* inputIntervalSet);
+RunInfo badMemoryDepthFirstParallel(IntervalSet* inputIntervalSet);
 RunInfo badMemoryAlgorithmParallelized(IntervalSet* inputIntervalSet);
+RunInfo badMemoryAlgorithmFrontier(IntervalSet* inputIntervalSet);
 
 #endif // BAD_MEMORY_ALG_H
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "graphNode.h"
 // #define DEBUG_PRINT 1
 #include "debug.h"
+#include "graphNodeTable.h"
+#include "memArena.h"
 #include <stdlib.h>
+#include <string.h>
 
 /**
  * Creates a new GraphNode with the specified i, s values and an empty list of
@@ -12,7 +15,7 @@
  * @return The newly created GraphNode.
  */
 GraphNode graphNodeCreate(const uint32_t i, const uint32_t s) {
-  return (GraphNode){.i = i, .s = s, .intervalSets = NULL, .markStorage = NULL};
+  return (GraphNode){.i = i, .s = s};
 }
 
 /**
@@ -24,146 +27,166 @@ GraphNode graphNodeCreate(const uint32_t i, const uint32_t s) {
 void graphNodeDelete(GraphNode* graphNode) {
   if (graphNode) {
     // delete the interval sets in the graph node
-    IntervalSetNode* intervalSetNode = graphNode->intervalSets;
-    while (intervalSetNode) {
-      IntervalSetNode* next = intervalSetNode->next;
-      intervalSetDelete(intervalSetNode->set);
-      intervalSetNode->set = NULL;
-      free(intervalSetNode);
-      intervalSetNode = next;
+    for (uint32_t k = 0; k < graphNode->nIntervalSets; k++) {
+      intervalSetDelete(graphNode->intervalSets[k]);
     }
+    memFree(graphNode->intervalSets);
     graphNode->intervalSets = NULL;
+    graphNode->nIntervalSets = 0;
+    graphNode->intervalSetCapacity = 0;
 
     // delete the mark storage
     markStorageDelete(&(graphNode->markStorage));
 
-    // delete the incoming and outgoing edges
-    graphNodeStorageDelete(&(graphNode->incoming));
-    graphNodeStorageDelete(&(graphNode->outgoing));
+    // delete the incoming edges, the outgoing ones are not stored
+    graphNodeStorageDelete(graphNode->incoming);
+    graphNode->incoming = NULL;
 
     // the graphNode itself does not need to be freed, only the array containing it
   }
 }
 
 /**
- * Deletes an IntervalSetNode and frees the memory allocated for it.
+ * Compares the sort keys of an IntervalSet and a (nIntervals, bottomSum) pair. A set can only be
+ * dominated by sets with the same number of intervals and at most the same bottom sum, so sorting
+ * by this key keeps all candidates for dominance next to each other.
  *
- * @param intervalSetNode The IntervalSetNode to be deleted.
+ * @param intervalSet The IntervalSet.
+ * @param nIntervals The number of intervals to compare with.
+ * @param bottomSum The bottom sum to compare with.
+ * @return True if the key of the set is less than the given one, false otherwise.
  */
-static void graphNodeDeleteIntervalSet(IntervalSetNode* intervalSetNode) {
-  if (intervalSetNode) {
-    intervalSetDelete(intervalSetNode->set);
-    intervalSetNode->set = NULL;
-    free(intervalSetNode);
-    intervalSetNode = NULL;
-  }
+static bool graphNodeKeyLess(const IntervalSet* intervalSet, const uint32_t nIntervals,
+                             const uint64_t bottomSum) {
+  return intervalSet->nIntervals < nIntervals ||
+         (intervalSet->nIntervals == nIntervals &&
+          intervalSet->fingerprint.bottomSum < bottomSum);
 }
 
 /**
- * Adds an IntervalSet to the specified GraphNode.
+ * Finds the first position of the sets of a GraphNode whose key is at least (nIntervals,
+ * bottomSum).
  *
- * @param graphNode A pointer to the GraphNode to which the IntervalSet will be
- * added.
- * @param intervalSet A pointer to the IntervalSet to be added.
+ * @param graphNode The GraphNode to search in.
+ * @param nIntervals The number of intervals of the key.
+ * @param bottomSum The bottom sum of the key.
+ * @return The position, nIntervalSets if all keys are less.
  */
-void graphNodeAddIntervalSet(GraphNode* graphNode, IntervalSet* intervalSet) {
-  IntervalSetNode* intervalSetNode = malloc(sizeof(IntervalSetNode));
-
-  if (intervalSetNode) {
-    intervalSetNode->set = intervalSet;
-    intervalSetNode->next = graphNode->intervalSets;
-    graphNode->intervalSets = intervalSetNode;
+static uint32_t graphNodeLowerBound(const GraphNode* graphNode, const uint32_t nIntervals,
+                                    const uint64_t bottomSum) {
+  uint32_t lo = 0, hi = graphNode->nIntervalSets;
+
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (graphNodeKeyLess(graphNode->intervalSets[mid], nIntervals, bottomSum)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
   }
+
+  return lo;
 }
 
 /**
- * Checks whether the specified IntervalSet should be added to the specified GraphNode, or if it is
- * dominated by another IntervalSet in the GraphNode.
+ * Inserts an IntervalSet into the sets of a GraphNode at the given position.
  *
- * @param graphNode The GraphNode to which the IntervalSet should be added.
- * @param intervalSet The IntervalSet to be added.
- * @return True if the IntervalSet should be added, false if it is dominated by another IntervalSet
- * in the GraphNode.
+ * @param graphNode The GraphNode to insert into.
+ * @param position The position of the new set.
+ * @param intervalSet The IntervalSet to insert.
+ * @return True if the set has been inserted, false if memory allocation fails.
  */
-bool graphNodeSetShouldBeAdded(const GraphNode* graphNode, const IntervalSet* intervalSet) {
-  IntervalSetNode* intervalSetNode = graphNode->intervalSets;
-
-  while (intervalSetNode) {
-    if (intervalSetIsDominatedBy(intervalSet, intervalSetNode->set)) {
+static bool graphNodeInsertAt(GraphNode* graphNode, const uint32_t position,
+                              IntervalSet* intervalSet) {
+  if (graphNode->nIntervalSets == graphNode->intervalSetCapacity) {
+    const uint32_t capacity = __max(2 * graphNode->intervalSetCapacity, 4);
+    IntervalSet** intervalSets =
+        memRealloc(graphNode->intervalSets, sizeof(IntervalSet*) * capacity);
+
+    if (!intervalSets) {
       return false;
     }
-    intervalSetNode = intervalSetNode->next;
+    graphNode->intervalSets = intervalSets;
+    graphNode->intervalSetCapacity = capacity;
   }
 
+  memmove(&(graphNode->intervalSets[position + 1]), &(graphNode->intervalSets[position]),
+          sizeof(IntervalSet*) * (graphNode->nIntervalSets - position));
+  graphNode->intervalSets[position] = intervalSet;
+  graphNode->nIntervalSets++;
+
   return true;
 }
 
 /**
- * Removes dominated sets from the graph node.
- * A set is considered dominated if there exists another set in the graph node
- * where all lower bounds are less than or equal to the lower bounds of the
- * dominated set.
+ * Adds an IntervalSet to the specified GraphNode, without checking for dominance. It is placed in
+ * front of the sets with the same key.
  *
- * @param graphNode The graph node from which to remove dominated sets.
+ * @param graphNode A pointer to the GraphNode to which the IntervalSet will be
+ * added.
+ * @param intervalSet A pointer to the IntervalSet to be added.
  */
-void graphNodeRemoveDominatedSets(GraphNode* graphNode) {
-  IntervalSetNode* outerSetNode = graphNode->intervalSets;
-
-  while (outerSetNode) {
-    IntervalSetNode* innerSetNode = outerSetNode->next;
-
-    while (innerSetNode) {
-
-      if (intervalSetIsDominatedBy(innerSetNode->set, outerSetNode->set)) {
-        // the innerSetNode is dominated by the outerSetNode => remove the innerSetNode
-
-        // get predecessor of innerSetNode
-        IntervalSetNode* pred = outerSetNode;
-        while (pred->next != innerSetNode) {
-          pred = pred->next;
-        }
-
-        // remove innerSetNode from list
-        IntervalSetNode* next = innerSetNode->next;
-        pred->next = next;
-
-        // delete innerSetNode
-        graphNodeDeleteIntervalSet(innerSetNode);
-
-        innerSetNode = next;
-
-      } else if (intervalSetIsDominatedBy(outerSetNode->set, innerSetNode->set)) {
-        // the outerSetNode is dominated by the innerSetNode => remove the outerSetNode
-
-        IntervalSetNode* next = outerSetNode->next;
-
-        // remove outerSetNode from list
-        IntervalSetNode* pred = graphNode->intervalSets;
-        if (pred == outerSetNode) {
-          graphNode->intervalSets = next;
-        } else {
-          while (pred->next != outerSetNode) {
-            pred = pred->next;
-          }
-          pred->next = next;
-        }
-
-        // delete outerSetNode
-        graphNodeDeleteIntervalSet(outerSetNode);
-
-        outerSetNode = next;
+void graphNodeAddIntervalSet(GraphNode* graphNode, IntervalSet* intervalSet) {
+  const uint32_t position = graphNodeLowerBound(graphNode, intervalSet->nIntervals,
+                                                intervalSet->fingerprint.bottomSum);
 
-        // continue with next outerSetNode
-        innerSetNode = outerSetNode->next;
+  graphNodeInsertAt(graphNode, position, intervalSet);
+}
 
-      } else {
+/**
+ * Inserts an IntervalSet into the Pareto front of the specified GraphNode. If it is dominated by
+ * another set of the node, it is deleted. Otherwise all sets it dominates are deleted, unless the
+ * mode is GRAPH_NODE_INSERT_NO_EVICT.
+ *
+ * @param graphNode The GraphNode to which the IntervalSet should be added.
+ * @param intervalSet The IntervalSet to be added, owned by the GraphNode afterwards.
+ * @param mode Whether an equal set of the node is replaced by the new one or counts as dominating
+ * it, and whether dominated sets are deleted at all.
+ * @return True if the IntervalSet has been added, false if it was dominated and has been deleted.
+ */
+bool graphNodeInsertIntervalSet(GraphNode* graphNode, IntervalSet* intervalSet,
+                                const GraphNodeInsertMode mode) {
+  const uint32_t nIntervals = intervalSet->nIntervals;
+  const uint64_t bottomSum = intervalSet->fingerprint.bottomSum;
+  const uint32_t first = graphNodeLowerBound(graphNode, nIntervals, 0);
+  const uint32_t position = graphNodeLowerBound(graphNode, nIntervals, bottomSum);
+
+  // sets with a smaller bottom sum can only dominate the new set, equal sets have the same sum
+  const uint32_t end = mode == GRAPH_NODE_INSERT_REPLACE_EQUAL
+                           ? position
+                           : graphNodeLowerBound(graphNode, nIntervals, bottomSum + 1);
+  for (uint32_t k = first; k < end; k++) {
+    if (intervalSetIsDominatedBy(intervalSet, graphNode->intervalSets[k])) {
+      intervalSetDelete(intervalSet);
+      return false;
+    }
+  }
 
-        innerSetNode = innerSetNode->next;
-      }
+  // sets with at least the same bottom sum can only be dominated by it, or be equal to it
+  uint32_t kept = position;
+  uint32_t k = position;
+  while (mode != GRAPH_NODE_INSERT_NO_EVICT && k < graphNode->nIntervalSets &&
+         graphNode->intervalSets[k]->nIntervals == nIntervals) {
+    IntervalSet* otherSet = graphNode->intervalSets[k++];
+
+    if (intervalSetIsDominatedBy(otherSet, intervalSet)) {
+      intervalSetDelete(otherSet);
+    } else {
+      graphNode->intervalSets[kept++] = otherSet;
     }
+  }
+  if (k > kept) {
+    memmove(&(graphNode->intervalSets[kept]), &(graphNode->intervalSets[k]),
+            sizeof(IntervalSet*) * (graphNode->nIntervalSets - k));
+    graphNode->nIntervalSets -= k - kept;
+  }
 
-    outerSetNode = outerSetNode->next;
+  if (!graphNodeInsertAt(graphNode, position, intervalSet)) {
+    intervalSetDelete(intervalSet);
+    return false;
   }
+
+  return true;
 }
 
 /**
@@ -173,16 +196,7 @@ void graphNodeRemoveDominatedSets(GraphNode* graphNode) {
  * @return The number of interval sets in the graph node.
  */
 uint32_t graphNodeGetNIntervalSets(const GraphNode* graphNode) {
-  uint32_t count = 0;
-
-  IntervalSetNode* intervalSetNode = graphNode->intervalSets;
-
-  while (intervalSetNode) {
-    count++;
-    intervalSetNode = intervalSetNode->next;
-  }
-
-  return count;
+  return graphNode->nIntervalSets;
 }
 
 /**
@@ -191,7 +205,7 @@ uint32_t graphNodeGetNIntervalSets(const GraphNode* graphNode) {
  * @param graphNode The GraphNode to be checked.
  * @return True if the GraphNode has any IntervalSets, false otherwise.
  */
-bool graphNodeHasIntervalSet(const GraphNode* graphNode) { return graphNode->intervalSets != NULL; }
+bool graphNodeHasIntervalSet(const GraphNode* graphNode) { return graphNode->nIntervalSets > 0; }
 
 /**
  * Prints the details of a GraphNode.
@@ -211,140 +225,87 @@ void graphNodePrint(const GraphNode* graphNode) {
 void graphNodePrintDetailed(const GraphNode* graphNode) {
   debug_print("GraphNode(%d, %d) [\n", graphNode->i, graphNode->s);
 
-  IntervalSetNode* intervalSetNode = graphNode->intervalSets;
-
-  while (intervalSetNode) {
-    intervalSetPrint(intervalSetNode->set);
-    intervalSetNode = intervalSetNode->next;
+  for (uint32_t k = 0; k < graphNode->nIntervalSets; k++) {
+    intervalSetPrint(graphNode->intervalSets[k]);
   }
 
   debug_print("]\n");
 }
 
 /**
- * Returns a pointer to the specified GraphNode in the 2D array of GraphNodes.
- *
- * @param graphNodes The 2D array of GraphNodes.
- * @param i The row index of the desired GraphNode (1-based index).
- * @param s The column index of the desired GraphNode (1-based index).
- * @return A pointer to the specified GraphNode.
- */
-GraphNode* getGraphNode(GraphNode** graphNodes, const uint32_t i, const uint32_t s) {
-  return &(graphNodes[i - 1][s - 1]);
-}
-
-/**
- * Checks whether a is greater than b.
- *
- * @param a The first value.
- * @param b The second value.
- * @return True if a is greater than b, false otherwise.
- */
-bool greater(int32_t a, int32_t b) { return a > b; }
-
-/**
- * Checks whether a is less than b.
- *
- * @param a The first value.
- * @param b The second value.
- * @return True if a is less than b, false otherwise.
- */
-bool less(int32_t a, int32_t b) { return a < b; }
-
-/**
- * Recursively finds the best path from a sink node (j, n) to a start node (i, i) in the datagraph.
- * Depending on the compare function and the initial value, this function can be used to find the
- * longest or shortest path.
+ * Computes the longest and the shortest path from a source node (i, i) to a sink node (j, n) with
+ * interval sets in the datagraph, following the incoming edges. Every edge goes from a node to one
+ * with a larger s-value, so a single pass over the existing nodes ordered by s sees all
+ * predecessors of a node before the node itself.
  *
- * @param graphNodes The 2D array of GraphNodes.
- * @param i The row index of the current GraphNode (1-based index).
- * @param s The column index of the current GraphNode (1-based index).
- * @param n The size of the square matrix (number of rows/columns).
- * @param compare The comparison function to use (greater or less).
- * @param initialValue The initial value to use (INT32_MIN or INT32_MAX).
- * @param visited The 2D array of ints, that saves all already computed best paths, in order to
- * avoid doing it twice.
- * @return The length of the longest path from the current node to the sink node.
+ * @param graphNodes The table of GraphNodes.
+ * @param longestPath Set to the length of the longest path, or -1 if there is no path.
+ * @param shortestPath Set to the length of the shortest path, or -1 if there is no path.
  */
-static int32_t getPathLengthRecursiveBackwards(GraphNode** graphNodes, const uint32_t i,
-                                               const uint32_t s, const uint32_t n,
-                                               CompareFunc compare, int32_t initialValue,
-                                               int32_t** visited) {
-  // if a starting node is reached, return 0
-  if (i == s) {
-    return 0;
+void graphNodeGetPathLengths(const GraphNodeTable* graphNodes, int32_t* longestPath,
+                             int32_t* shortestPath) {
+  const uint32_t n = graphNodeTableGetN(graphNodes);
+  const uint32_t nNodes = graphNodeTableGetNNodes(graphNodes);
+
+  *longestPath = -1;
+  *shortestPath = -1;
+
+  // the longest and shortest path to every node, -1 if no source node reaches it
+  int32_t* longest = malloc(sizeof(int32_t) * __max(nNodes, 1));
+  int32_t* shortest = malloc(sizeof(int32_t) * __max(nNodes, 1));
+  // the positions of the nodes, bucketed by their s-value
+  uint32_t* order = malloc(sizeof(uint32_t) * __max(nNodes, 1));
+  uint32_t* bucketStart = calloc(n + 2, sizeof(uint32_t));
+
+  if (!longest || !shortest || !order || !bucketStart) {
+    free(longest);
+    free(shortest);
+    free(order);
+    free(bucketStart);
+    return;
   }
 
-  // if the path from this node has already been computed, return it to avoid doing it twice
-  if (visited[i - 1][s - 1] != -1) {
-    return visited[i - 1][s - 1];
+  for (uint32_t k = 0; k < nNodes; k++) {
+    bucketStart[graphNodeTableGetNodeAt(graphNodes, k)->s + 1]++;
   }
-
-  GraphNode* currNode = getGraphNode(graphNodes, i, s);
-  int32_t bestPath = initialValue;
-
-  GraphNodeStorageNode* incomingNode = currNode->incoming;
-  while (incomingNode) {
-    int32_t pathLength = getPathLengthRecursiveBackwards(
-        graphNodes, incomingNode->i, incomingNode->s, n, compare, initialValue, visited);
-    if (compare(pathLength, bestPath)) {
-      bestPath = pathLength;
-    }
-    incomingNode = incomingNode->next;
+  for (uint32_t s = 1; s <= n + 1; s++) {
+    bucketStart[s] += bucketStart[s - 1];
   }
-
-  int32_t res = bestPath + (bestPath != initialValue ? 1 : 0);
-  visited[i - 1][s - 1] = res;
-  return res;
-}
-
-/**
- * Finds the best path from a sink node (j, n) to a source node (i, i) in the datagraph. Depending
- * on the compare function and the initial value, this function can be used to find the longest or
- * shortest path.
- *
- * @param graphNodes The 2D array of GraphNodes.
- * @param n The size of the square matrix (number of rows/columns).
- * @param compare The comparison function to use (greater or less).
- * @param initialValue The initial value to use (INT32_MIN or INT32_MAX).
- * @return The length of the longest path from the source node to the sink node.
- */
-int32_t graphNodeGetPathLengthBackwards(GraphNode** graphNodes, const uint32_t n,
-                                        CompareFunc compare, int32_t initialValue) {
-  int32_t bestPath = initialValue;
-
-  // the visited array is used to keep track of which nodes have already been visited
-  int32_t** visited = malloc(n * sizeof(int32_t*));
-  for (uint32_t i = 0; i < n; i++) {
-    visited[i] = malloc(n * sizeof(int32_t));
-    for (uint32_t j = 0; j < n; j++) {
-      visited[i][j] = -1;
-    }
+  for (uint32_t k = 0; k < nNodes; k++) {
+    order[bucketStart[graphNodeTableGetNodeAt(graphNodes, k)->s]++] = k;
   }
 
-  for (uint32_t i = 1; i <= n; i++) {
-    GraphNode* currNode = getGraphNode(graphNodes, i, n);
-    if (graphNodeHasIntervalSet(currNode)) {
-      printf("Calculating path length for node (%d, %d)\n", i, n);
-      fflush(stdout);
-      int32_t pathLength =
-          getPathLengthRecursiveBackwards(graphNodes, i, n, n, compare, initialValue, visited);
-      if (compare(pathLength, bestPath)) {
-        bestPath = pathLength;
+  for (uint32_t o = 0; o < nNodes; o++) {
+    const uint32_t k = order[o];
+    const GraphNode* currNode = graphNodeTableGetNodeAt(graphNodes, k);
+
+    // the source nodes start the paths and have no predecessors, all other nodes extend the paths
+    // of their predecessors
+    longest[k] = currNode->i == currNode->s ? 0 : -1;
+    shortest[k] = longest[k];
+
+    const GraphNodeStorage* incoming = currNode->incoming;
+    for (uint32_t e = 0; e < graphNodeStorageGetNNodes(incoming); e++) {
+      const uint32_t predK = graphNodeTableFindIndex(graphNodes, graphNodeStorageGetI(incoming, e),
+                                                     graphNodeStorageGetS(incoming, e));
+      if (predK == GRAPH_NODE_TABLE_NOT_FOUND || longest[predK] < 0) {
+        continue;
       }
-    }
-  }
 
-  // free the visited array
-  for (uint32_t i = 0; i < n; i++) {
-    free(visited[i]);
-  }
-  free(visited);
+      longest[k] = __max(longest[k], longest[predK] + 1);
+      shortest[k] =
+          shortest[k] < 0 ? shortest[predK] + 1 : __min(shortest[k], shortest[predK] + 1);
+    }
 
-  // if no path was found, return -1
-  if (bestPath == initialValue) {
-    bestPath = -1;
+    // the paths end in the sink nodes that hold a solution
+    if (currNode->s == n && graphNodeHasIntervalSet(currNode) && longest[k] >= 0) {
+      *longestPath = __max(*longestPath, longest[k]);
+      *shortestPath = *shortestPath < 0 ? shortest[k] : __min(*shortestPath, shortest[k]);
+    }
   }
 
-  return bestPath;
+  free(longest);
+  free(shortest);
+  free(order);
+  free(bucketStart);
 }
@@ -7,45 +7,42 @@
 #include <stdint.h>
 
 typedef struct IntervalSet IntervalSet;
-typedef struct MarkNode MarkNode;
-typedef MarkNode* MarkStorage;
-typedef struct GraphNodeStorageNode GraphNodeStorageNode;
-typedef GraphNodeStorageNode* GraphNodeStorage;
+typedef struct GraphNodeTable GraphNodeTable;
 
 /**
- * @brief Structure representing a node in a linked list of interval sets.
+ * @brief How graphNodeInsertIntervalSet treats the sets that are already in the node.
  */
-typedef struct IntervalSetNode {
-  IntervalSet* set;             /** Pointer to the interval set. */
-  struct IntervalSetNode* next; /** Pointer to the next interval set node in the linked list. */
-} IntervalSetNode;
+typedef enum GraphNodeInsertMode {
+  GRAPH_NODE_INSERT_REPLACE_EQUAL = 0, /** Deletes the dominated sets, including an equal one. */
+  GRAPH_NODE_INSERT_KEEP_EQUAL = 1,    /** Deletes the dominated sets, but keeps an equal one. */
+  GRAPH_NODE_INSERT_NO_EVICT = 2       /** Never removes a set, keeps an equal one. */
+} GraphNodeInsertMode;
 
 /**
  * @brief Structure representing a data-node in the dynamic program.
  */
 typedef struct GraphNode {
-  uint32_t i;                    /** The i-value of the graph node. */
-  uint32_t s;                    /** The s-value of the graph node. */
-  IntervalSetNode* intervalSets; /** Pointer to the linked list of interval
-                                    sets associated with the graph node. */
-  MarkStorage markStorage;       /** Mark storage associated with the graph node. */
-  GraphNodeStorage incoming;     /** The incoming edges of the graph node. */
-  GraphNodeStorage outgoing;     /** The outgoing edges of the graph node. */
+  uint32_t i;                   /** The i-value of the graph node. */
+  uint32_t s;                   /** The s-value of the graph node. */
+  IntervalSet** intervalSets;   /** The interval sets of the graph node, sorted by their number of
+                                    intervals and then by their bottom sum until a breadth first
+                                    engine has finished the node. */
+  uint32_t nIntervalSets;       /** The number of interval sets of the graph node. */
+  uint32_t intervalSetCapacity; /** The capacity of the intervalSets array. */
+  MarkStorage markStorage;      /** Mark storage associated with the graph node. */
+  GraphNodeStorage* incoming;   /** The incoming edges of the graph node, NULL until the first
+                                    edge is recorded. */
 } GraphNode;
 
 GraphNode graphNodeCreate(const uint32_t i, const uint32_t s);
 void graphNodeDelete(GraphNode* graphNode);
 void graphNodeAddIntervalSet(GraphNode* graphNode, IntervalSet* intervalSet);
-bool graphNodeSetShouldBeAdded(const GraphNode* graphNode, const IntervalSet* intervalSet);
-void graphNodeRemoveDominatedSets(GraphNode* graphNode);
+bool graphNodeInsertIntervalSet(GraphNode* graphNode, IntervalSet* intervalSet,
+                                const GraphNodeInsertMode mode);
 uint32_t graphNodeGetNIntervalSets(const GraphNode* graphNode);
 void graphNodePrint(const GraphNode* graphNode);
 void graphNodePrintDetailed(const GraphNode* graphNode);
-GraphNode* getGraphNode(GraphNode** graphNodes, const uint32_t i, const uint32_t s);
-typedef bool (*CompareFunc)(int32_t, int32_t);
-bool greater(int32_t a, int32_t b);
-bool less(int32_t a, int32_t b);
-int32_t graphNodeGetPathLengthBackwards(GraphNode** graphNodes, const uint32_t n,
-                                        CompareFunc compare, int32_t initialValue);
+void graphNodeGetPathLengths(const GraphNodeTable* graphNodes, int32_t* longestPath,
+                             int32_t* shortestPath);
 
 #endif // GRAPH_NODE_H
\ No newline at end of file
@@ -1,22 +1,89 @@
 #include "graphNodeStorage.h"
+#include "graphNode.h"
+#include "memArena.h"
 #include <stdlib.h>
 
+/**
+ * Sets with up to this many GraphNodes are searched linearly, larger ones get a hash set.
+ */
+#define GRAPH_NODE_STORAGE_LINEAR_MAX 8
+
+/**
+ * Packs the i- and s-value of a GraphNode into a single id, which is never 0.
+ *
+ * @param graphNode The GraphNode.
+ * @return The packed id.
+ */
+static uint64_t graphNodeStoragePackId(const GraphNode* graphNode) {
+  return (uint64_t)graphNode->i << 32 | graphNode->s;
+}
+
+/**
+ * Finds the hash slot of the given id, or the empty slot where it would have to be inserted.
+ *
+ * @param slots The hash slots.
+ * @param slotCapacity The number of hash slots, a power of two.
+ * @param id The id to search for.
+ * @return The position of the slot.
+ */
+static uint32_t graphNodeStorageFindSlot(const uint64_t slots[], const uint32_t slotCapacity,
+                                         const uint64_t id) {
+  uint32_t slot = (uint32_t)((id * 0x9E3779B97F4A7C15ull) >> 32) & (slotCapacity - 1);
+
+  while (slots[slot] && slots[slot] != id) {
+    slot = (slot + 1) & (slotCapacity - 1);
+  }
+
+  return slot;
+}
+
+/**
+ * Rebuilds the hash set of the GraphNodeStorage with room for at least twice its ids.
+ *
+ * @param graphNodeStorage The GraphNodeStorage whose hash set should be rebuilt.
+ */
+static void graphNodeStorageRehash(GraphNodeStorage* graphNodeStorage) {
+  uint32_t slotCapacity = 2 * GRAPH_NODE_STORAGE_LINEAR_MAX;
+  while (slotCapacity < 4 * graphNodeStorage->length) {
+    slotCapacity *= 2;
+  }
+
+  uint64_t* slots = memAlloc(sizeof(uint64_t) * slotCapacity);
+  if (!slots) {
+    return;
+  }
+
+  for (uint32_t slot = 0; slot < slotCapacity; slot++) {
+    slots[slot] = 0;
+  }
+  for (uint32_t k = 0; k < graphNodeStorage->length; k++) {
+    const uint64_t id = graphNodeStorage->ids[k];
+    slots[graphNodeStorageFindSlot(slots, slotCapacity, id)] = id;
+  }
+
+  memFree(graphNodeStorage->slots);
+  graphNodeStorage->slots = slots;
+  graphNodeStorage->slotCapacity = slotCapacity;
+}
+
 /**
  * Checks if a GraphNode is contained in the GraphNodeStorage.
  *
  * @param graphNodeStorage The GraphNodeStorage to search in.
- * @param graphNode The GraphNode to check for.
+ * @param id The packed id of the GraphNode to check for.
  * @returns true if the GraphNode is contained in the GraphNodeStorage, false otherwise.
  */
 static bool graphNodeStorageContainsNode(const GraphNodeStorage* graphNodeStorage,
-                                         const GraphNode* graphNode) {
-  GraphNodeStorageNode* currNode = *graphNodeStorage;
+                                         const uint64_t id) {
+  if (graphNodeStorage->slotCapacity) {
+    const uint64_t* slots = graphNodeStorage->slots;
+    return slots[graphNodeStorageFindSlot(slots, graphNodeStorage->slotCapacity, id)] == id;
+  }
 
-  while (currNode) {
-    if (currNode->i == graphNode->i && currNode->s == graphNode->s) {
+  for (uint32_t k = 0; k < graphNodeStorage->length; k++) {
+    if (graphNodeStorage->ids[k] == id) {
       return true;
     }
-    currNode = currNode->next;
   }
 
   return false;
@@ -29,64 +96,104 @@ static bool graphNodeStorageContainsNode(const GraphNodeStorage* graphNodeStorag
  * @param graphNode A pointer to the GraphNode to be added.
  */
 static void graphNodeStorageAddNode(GraphNodeStorage* graphNodeStorage, GraphNode* graphNode) {
-  if (graphNode && !graphNodeStorageContainsNode(graphNodeStorage, graphNode)) {
-    GraphNodeStorageNode* storageNode = malloc(sizeof(GraphNodeStorageNode));
+  if (!graphNode) {
+    return;
+  }
+
+  const uint64_t id = graphNodeStoragePackId(graphNode);
+  if (graphNodeStorageContainsNode(graphNodeStorage, id)) {
+    return;
+  }
+
+  if (graphNodeStorage->length == graphNodeStorage->capacity) {
+    const uint32_t capacity = __max(2 * graphNodeStorage->capacity, 4);
+    uint64_t* ids = memRealloc(graphNodeStorage->ids, sizeof(uint64_t) * capacity);
+
+    if (!ids) {
+      return;
+    }
+    graphNodeStorage->ids = ids;
+    graphNodeStorage->capacity = capacity;
+  }
 
-    storageNode->i = graphNode->i;
-    storageNode->s = graphNode->s;
-    storageNode->next = *graphNodeStorage;
+  graphNodeStorage->ids[graphNodeStorage->length++] = id;
 
-    *graphNodeStorage = storageNode;
+  // keep the load factor of the hash set at most one half
+  if (graphNodeStorage->slotCapacity) {
+    if (2 * graphNodeStorage->length > graphNodeStorage->slotCapacity) {
+      graphNodeStorageRehash(graphNodeStorage);
+    } else {
+      uint64_t* slots = graphNodeStorage->slots;
+      slots[graphNodeStorageFindSlot(slots, graphNodeStorage->slotCapacity, id)] = id;
+    }
+  } else if (graphNodeStorage->length > GRAPH_NODE_STORAGE_LINEAR_MAX) {
+    graphNodeStorageRehash(graphNodeStorage);
   }
 }
 
 /**
- * Connects two GraphNodes in the GraphNodeStorage.
+ * Records an edge between two GraphNodes in the incoming edges of its target, which get their
+ * storage with the first edge. Only modifies toNode, so no synchronization is needed as long as
+ * every node is only extended by one thread at a time. The outgoing edges are not stored, they
+ * are derived afterwards, see graphNodeTableCountOutgoing.
  *
  * @param fromNode The GraphNode from which the edge will be directed.
  * @param toNode The GraphNode to which the edge will be directed.
  */
-void graphNodeStorageConnectNodes(GraphNode* fromNode, GraphNode* toNode) {
-#pragma omp critical
-  {
-    graphNodeStorageAddNode(&(fromNode->outgoing), toNode);
-    graphNodeStorageAddNode(&(toNode->incoming), fromNode);
+void graphNodeStorageConnectIncoming(GraphNode* fromNode, GraphNode* toNode) {
+  if (!toNode->incoming) {
+    toNode->incoming = memAlloc(sizeof(GraphNodeStorage));
+
+    if (!toNode->incoming) {
+      return;
+    }
+    *(toNode->incoming) = (GraphNodeStorage){0};
   }
+
+  graphNodeStorageAddNode(toNode->incoming, fromNode);
 }
 
 /**
- * Deletes a GraphNodeStorage and frees the memory allocated for it.
+ * Deletes a GraphNodeStorage and frees the memory allocated for it, including the storage itself.
  *
- * @param graphNodeStorage A pointer to the GraphNodeStorage to be deleted.
+ * @param graphNodeStorage A pointer to the GraphNodeStorage to be deleted, may be NULL.
  */
 void graphNodeStorageDelete(GraphNodeStorage* graphNodeStorage) {
   if (graphNodeStorage) {
-    GraphNodeStorageNode* currNode = *graphNodeStorage;
-
-    while (currNode) {
-      GraphNodeStorageNode* nextNode = currNode->next;
-      free(currNode);
-      currNode = nextNode;
-    }
-
-    *graphNodeStorage = NULL;
+    memFree(graphNodeStorage->ids);
+    memFree(graphNodeStorage->slots);
+    memFree(graphNodeStorage);
   }
 }
 
 /**
  * Returns the number of nodes in the graph node storage.
  *
- * @param graphNodeStorage The graph node storage.
+ * @param graphNodeStorage The graph node storage, NULL for the empty set.
  * @returns The number of nodes in the graph node storage.
  */
 uint32_t graphNodeStorageGetNNodes(const GraphNodeStorage* graphNodeStorage) {
-  uint32_t nNodes = 0;
-  GraphNodeStorageNode* currNode = *graphNodeStorage;
+  return graphNodeStorage ? graphNodeStorage->length : 0;
+}
 
-  while (currNode) {
-    nNodes++;
-    currNode = currNode->next;
-  }
+/**
+ * Returns the i-value of the k-th node in the graph node storage.
+ *
+ * @param graphNodeStorage The graph node storage.
+ * @param k The position of the node, less than the number of nodes.
+ * @returns The i-value of the node.
+ */
+uint32_t graphNodeStorageGetI(const GraphNodeStorage* graphNodeStorage, const uint32_t k) {
+  return (uint32_t)(graphNodeStorage->ids[k] >> 32);
+}
 
-  return nNodes;
-}
\ No newline at end of file
+/**
+ * Returns the s-value of the k-th node in the graph node storage.
+ *
+ * @param graphNodeStorage The graph node storage.
+ * @param k The position of the node, less than the number of nodes.
+ * @returns The s-value of the node.
+ */
+uint32_t graphNodeStorageGetS(const GraphNodeStorage* graphNodeStorage, const uint32_t k) {
+  return (uint32_t)graphNodeStorage->ids[k];
+}
@@ -1,21 +1,28 @@
 #ifndef GRAPH_NODE_STORAGE_H
 #define GRAPH_NODE_STORAGE_H
 
-#include "graphNode.h"
 #include <stdint.h>
 
 typedef struct GraphNode GraphNode;
 
-typedef struct GraphNodeStorageNode {
-  uint32_t i;
-  uint32_t s;
-  struct GraphNodeStorageNode* next;
-} GraphNodeStorageNode;
+/**
+ * @brief A set of GraphNodes, stored as their packed (i << 32 | s) ids in insertion order. Larger
+ * sets additionally keep a hash set of the ids, so duplicates are detected in constant time. A
+ * GraphNode only refers to one for its incoming edges once it has any, so a NULL GraphNodeStorage
+ * stands for the empty set.
+ */
+typedef struct GraphNodeStorage {
+  uint64_t* ids;         /** The packed ids of the GraphNodes in the set. */
+  uint32_t length;       /** The number of GraphNodes in the set. */
+  uint32_t capacity;     /** The capacity of the ids array. */
+  uint64_t* slots;       /** Open addressing hash set of the ids, 0 marks an empty slot. */
+  uint32_t slotCapacity; /** The number of hash slots, 0 as long as the set is small. */
+} GraphNodeStorage;
 
-typedef GraphNodeStorageNode* GraphNodeStorage;
-
-void graphNodeStorageConnectNodes(GraphNode* fromNode, GraphNode* toNode);
+void graphNodeStorageConnectIncoming(GraphNode* fromNode, GraphNode* toNode);
 void graphNodeStorageDelete(GraphNodeStorage* graphNodeStorage);
 uint32_t graphNodeStorageGetNNodes(const GraphNodeStorage* graphNodeStorage);
+uint32_t graphNodeStorageGetI(const GraphNodeStorage* graphNodeStorage, const uint32_t k);
+uint32_t graphNodeStorageGetS(const GraphNodeStorage* graphNodeStorage, const uint32_t k);
 
-#endif // GRAPH_NODE_STORAGE_H
\ No newline at end of file
+#endif // GRAPH_NODE_STORAGE_H
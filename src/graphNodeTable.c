@@ -0,0 +1,463 @@
+#include "graphNodeTable.h"
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The number of nodes in the first block in the sparse modes, must be a power of two. Every
+ * further block holds twice as many nodes as the one before, so GRAPH_NODE_TABLE_MAX_BLOCKS blocks
+ * cover all positions below GRAPH_NODE_TABLE_NOT_FOUND.
+ */
+#define GRAPH_NODE_TABLE_BLOCK_SIZE 256
+#define GRAPH_NODE_TABLE_MAX_BLOCKS 25
+
+/**
+ * The initial number of hash slots of a shard in the sparse modes, must be a power of two.
+ */
+#define GRAPH_NODE_TABLE_INITIAL_CAPACITY 16
+
+/**
+ * In the sparse modes the hash slots are split into 2^GRAPH_NODE_TABLE_SHARD_BITS shards. In
+ * concurrent mode each has a lock of its own, so accesses only contend if their nodes hash to the
+ * same shard.
+ */
+#define GRAPH_NODE_TABLE_SHARD_BITS 6
+#define GRAPH_NODE_TABLE_N_SHARDS (1u << GRAPH_NODE_TABLE_SHARD_BITS)
+
+/**
+ * @brief A hash slot of a sparse table. The hash is kept next to the position, so probing only
+ * looks at the nodes whose hash matches.
+ */
+typedef struct GraphNodeTableSlot {
+  uint32_t hash;     /** The hash of the node. */
+  uint32_t position; /** The position of the node plus one, 0 marks an empty slot. */
+} GraphNodeTableSlot;
+
+/**
+ * @brief A shard of the hash slots of a sparse table, holding the nodes whose hash selects it.
+ * Padded to a cache line, so the locks of different shards do not share one.
+ */
+typedef struct GraphNodeTableShard {
+  GraphNodeTableSlot* slots; /** The hash slots. */
+  uint32_t capacity;         /** The number of hash slots, a power of two. */
+  uint32_t nNodes;           /** The number of nodes in the shard. */
+  omp_lock_t lock;           /** Concurrent mode: guards the slots, capacity and nNodes. */
+} __attribute__((aligned(64))) GraphNodeTableShard;
+
+struct GraphNodeTable {
+  GraphNodeTableMode mode; /** The storage mode of the table. */
+  uint32_t n;              /** The largest i- and s-value of the nodes. */
+  uint32_t nNodes;         /** The number of nodes that exist. */
+  GraphNode* nodes;        /** Triangular mode: all nodes, (i, s) at s * (s - 1) / 2 + i - 1. */
+
+  GraphNodeTableShard* shards;                    /** Sparse modes: the hash slots, in shards. */
+  GraphNode* blocks[GRAPH_NODE_TABLE_MAX_BLOCKS]; /** Sparse modes: the blocks of the nodes. */
+};
+
+/**
+ * Computes the position of the node (i, s) in the packed triangular array.
+ *
+ * @param i The i-value of the node.
+ * @param s The s-value of the node, at least i.
+ * @return The position of the node.
+ */
+static size_t graphNodeTableTriangularIndex(const uint32_t i, const uint32_t s) {
+  return (size_t)s * (s - 1) / 2 + i - 1;
+}
+
+/**
+ * Computes the hash of the node (i, s). The high bits select the shard, the low bits the slot.
+ *
+ * @param i The i-value of the node.
+ * @param s The s-value of the node.
+ * @return The hash value.
+ */
+static uint32_t graphNodeTableHash(const uint32_t i, const uint32_t s) {
+  uint64_t key = ((uint64_t)i << 32 | s) * 0x9E3779B97F4A7C15ull;
+  return (uint32_t)(key >> 32);
+}
+
+/**
+ * Returns the node at the given position of a sparse table. Block b starts at position
+ * GRAPH_NODE_TABLE_BLOCK_SIZE * (2^b - 1) and is only allocated once a node is created in it.
+ *
+ * @param table The sparse table.
+ * @param k The position of the node.
+ * @return A pointer to the node.
+ */
+static GraphNode* graphNodeTableBlockNode(const GraphNodeTable* table, const uint32_t k) {
+  const uint32_t block = 31 - __builtin_clz(k / GRAPH_NODE_TABLE_BLOCK_SIZE + 1);
+  const uint32_t offset = k - GRAPH_NODE_TABLE_BLOCK_SIZE * ((1u << block) - 1);
+
+  return &(table->blocks[block][offset]);
+}
+
+/**
+ * Returns the shard of a sparse table the given hash selects and, in concurrent mode, locks it.
+ *
+ * @param table The sparse table.
+ * @param hash The hash of the node.
+ * @return The locked shard.
+ */
+static GraphNodeTableShard* graphNodeTableLockShard(const GraphNodeTable* table,
+                                                    const uint32_t hash) {
+  GraphNodeTableShard* shard = &(table->shards[hash >> (32 - GRAPH_NODE_TABLE_SHARD_BITS)]);
+
+  if (table->mode == GRAPH_NODE_TABLE_CONCURRENT) {
+    omp_set_lock(&(shard->lock));
+  }
+
+  return shard;
+}
+
+/**
+ * Unlocks a shard locked by graphNodeTableLockShard.
+ *
+ * @param table The sparse table.
+ * @param shard The shard to unlock.
+ */
+static void graphNodeTableUnlockShard(const GraphNodeTable* table, GraphNodeTableShard* shard) {
+  if (table->mode == GRAPH_NODE_TABLE_CONCURRENT) {
+    omp_unset_lock(&(shard->lock));
+  }
+}
+
+/**
+ * Finds the hash slot of the node (i, s), or the empty slot where it would have to be inserted.
+ *
+ * @param table The sparse table whose nodes the slots refer to.
+ * @param slots The hash slots.
+ * @param capacity The number of hash slots, a power of two.
+ * @param hash The hash of the node.
+ * @param i The i-value of the node.
+ * @param s The s-value of the node.
+ * @return The position of the slot.
+ */
+static uint32_t graphNodeTableFindSlot(const GraphNodeTable* table,
+                                       const GraphNodeTableSlot slots[], const uint32_t capacity,
+                                       const uint32_t hash, const uint32_t i, const uint32_t s) {
+  uint32_t slot = hash & (capacity - 1);
+
+  while (slots[slot].position) {
+    if (slots[slot].hash == hash) {
+      const GraphNode* node = graphNodeTableBlockNode(table, slots[slot].position - 1);
+      if (node->i == i && node->s == s) {
+        break;
+      }
+    }
+    slot = (slot + 1) & (capacity - 1);
+  }
+
+  return slot;
+}
+
+/**
+ * Doubles the number of hash slots of a shard and reinserts its nodes. In concurrent mode the
+ * shard has to be locked.
+ *
+ * @param shard The shard to grow.
+ * @return True if the shard has been grown, false if memory allocation fails.
+ */
+static bool graphNodeTableGrow(GraphNodeTableShard* shard) {
+  const uint32_t newCapacity = shard->capacity * 2;
+  GraphNodeTableSlot* newSlots = calloc(newCapacity, sizeof(GraphNodeTableSlot));
+
+  if (!newSlots) {
+    return false;
+  }
+
+  for (uint32_t slot = 0; slot < shard->capacity; slot++) {
+    // all nodes of the shard are distinct, so the first empty slot is the one
+    if (shard->slots[slot].position) {
+      uint32_t newSlot = shard->slots[slot].hash & (newCapacity - 1);
+      while (newSlots[newSlot].position) {
+        newSlot = (newSlot + 1) & (newCapacity - 1);
+      }
+      newSlots[newSlot] = shard->slots[slot];
+    }
+  }
+
+  free(shard->slots);
+  shard->slots = newSlots;
+  shard->capacity = newCapacity;
+
+  return true;
+}
+
+/**
+ * Creates the node (i, s) at the next free position of a sparse table, allocating the block of
+ * that position first if needed. The blocks are never reallocated, so the nodes keep their
+ * addresses. Nodes are only created one at a time, so the positions stay dense even in concurrent
+ * mode, where the calling thread holds the lock of the shard the node will be inserted into.
+ *
+ * @param table The sparse table.
+ * @param i The i-value of the node.
+ * @param s The s-value of the node.
+ * @return The position of the new node, or GRAPH_NODE_TABLE_NOT_FOUND if memory allocation fails.
+ */
+static uint32_t graphNodeTableAppendNode(GraphNodeTable* table, const uint32_t i,
+                                         const uint32_t s) {
+  uint32_t k = GRAPH_NODE_TABLE_NOT_FOUND;
+
+#pragma omp critical(graphNodeTableAppend)
+  {
+    const uint32_t block = 31 - __builtin_clz(table->nNodes / GRAPH_NODE_TABLE_BLOCK_SIZE + 1);
+
+    if (!table->blocks[block]) {
+      table->blocks[block] =
+          malloc(sizeof(GraphNode) * ((size_t)GRAPH_NODE_TABLE_BLOCK_SIZE << block));
+    }
+
+    if (table->blocks[block]) {
+      k = table->nNodes++;
+      *graphNodeTableBlockNode(table, k) = graphNodeCreate(i, s);
+    }
+  }
+
+  return k;
+}
+
+/**
+ * Creates a new GraphNodeTable for the nodes with 1 <= i <= s <= n. In triangular mode all nodes
+ * are created right away, in the sparse modes they are created when they are first accessed.
+ *
+ * @param n The largest i- and s-value of the nodes.
+ * @param mode The storage mode of the table.
+ * @return A pointer to the newly created table, or NULL if memory allocation fails or, in
+ * triangular mode, there are too many nodes for their positions to fit below
+ * GRAPH_NODE_TABLE_NOT_FOUND.
+ */
+GraphNodeTable* graphNodeTableCreate(const uint32_t n, const GraphNodeTableMode mode) {
+  const uint64_t nNodesMax = (uint64_t)n * (n + 1) / 2;
+
+  if (mode == GRAPH_NODE_TABLE_TRIANGULAR && nNodesMax >= GRAPH_NODE_TABLE_NOT_FOUND) {
+    return NULL;
+  }
+
+  GraphNodeTable* table = calloc(1, sizeof(GraphNodeTable));
+
+  if (!table) {
+    return NULL;
+  }
+
+  table->mode = mode;
+  table->n = n;
+
+  if (mode == GRAPH_NODE_TABLE_TRIANGULAR) {
+    table->nNodes = (uint32_t)nNodesMax;
+    table->nodes = malloc(sizeof(GraphNode) * __max((size_t)table->nNodes, 1));
+
+    if (!table->nodes) {
+      free(table);
+      return NULL;
+    }
+
+    for (uint32_t s = 1; s <= n; s++) {
+      for (uint32_t i = 1; i <= s; i++) {
+        table->nodes[graphNodeTableTriangularIndex(i, s)] = graphNodeCreate(i, s);
+      }
+    }
+  } else {
+    void* shards = NULL;
+    if (posix_memalign(&shards, 64, sizeof(GraphNodeTableShard) * GRAPH_NODE_TABLE_N_SHARDS)) {
+      free(table);
+      return NULL;
+    }
+    memset(shards, 0, sizeof(GraphNodeTableShard) * GRAPH_NODE_TABLE_N_SHARDS);
+    table->shards = shards;
+
+    for (uint32_t h = 0; h < GRAPH_NODE_TABLE_N_SHARDS; h++) {
+      GraphNodeTableShard* shard = &(table->shards[h]);
+
+      if (mode == GRAPH_NODE_TABLE_CONCURRENT) {
+        omp_init_lock(&(shard->lock));
+      }
+
+      shard->capacity = GRAPH_NODE_TABLE_INITIAL_CAPACITY;
+      shard->slots = calloc(shard->capacity, sizeof(GraphNodeTableSlot));
+      if (!shard->slots) {
+        graphNodeTableDelete(table);
+        return NULL;
+      }
+    }
+  }
+
+  return table;
+}
+
+/**
+ * Deletes the given GraphNodeTable and frees the memory of its nodes. Does not delete the interval
+ * sets, mark storages and edges of the nodes, see graphNodeDelete.
+ *
+ * @param table The table to be deleted.
+ */
+void graphNodeTableDelete(GraphNodeTable* table) {
+  if (table) {
+    free(table->nodes);
+
+    for (uint32_t b = 0; b < GRAPH_NODE_TABLE_MAX_BLOCKS; b++) {
+      free(table->blocks[b]);
+    }
+
+    if (table->shards) {
+      for (uint32_t h = 0; h < GRAPH_NODE_TABLE_N_SHARDS; h++) {
+        free(table->shards[h].slots);
+
+        if (table->mode == GRAPH_NODE_TABLE_CONCURRENT) {
+          omp_destroy_lock(&(table->shards[h].lock));
+        }
+      }
+      free(table->shards);
+    }
+
+    free(table);
+  }
+}
+
+/**
+ * Returns the node (i, s) of the table, creating it first in the sparse modes if it does not exist
+ * yet. In sparse mode the table must not be accessed concurrently, in concurrent mode it may.
+ *
+ * @param table The table to get the node from.
+ * @param i The i-value of the node.
+ * @param s The s-value of the node, with i <= s <= n.
+ * @return A pointer to the node, or NULL if memory allocation fails.
+ */
+GraphNode* graphNodeTableGet(GraphNodeTable* table, const uint32_t i, const uint32_t s) {
+  if (table->mode == GRAPH_NODE_TABLE_TRIANGULAR) {
+    return &(table->nodes[graphNodeTableTriangularIndex(i, s)]);
+  }
+
+  const uint32_t hash = graphNodeTableHash(i, s);
+  GraphNodeTableShard* shard = graphNodeTableLockShard(table, hash);
+  GraphNode* node = NULL;
+
+  uint32_t slot = graphNodeTableFindSlot(table, shard->slots, shard->capacity, hash, i, s);
+  if (shard->slots[slot].position) {
+    node = graphNodeTableBlockNode(table, shard->slots[slot].position - 1);
+  } else {
+    // keep the load factor at most one half
+    bool hasRoom = 2 * (shard->nNodes + 1) <= shard->capacity;
+    if (!hasRoom && graphNodeTableGrow(shard)) {
+      slot = graphNodeTableFindSlot(table, shard->slots, shard->capacity, hash, i, s);
+      hasRoom = true;
+    }
+
+    const uint32_t k = hasRoom ? graphNodeTableAppendNode(table, i, s) : GRAPH_NODE_TABLE_NOT_FOUND;
+    if (k != GRAPH_NODE_TABLE_NOT_FOUND) {
+      shard->slots[slot] = (GraphNodeTableSlot){hash, k + 1};
+      shard->nNodes++;
+      node = graphNodeTableBlockNode(table, k);
+    }
+  }
+
+  graphNodeTableUnlockShard(table, shard);
+
+  return node;
+}
+
+/**
+ * Returns the node (i, s) of the table without creating it.
+ *
+ * @param table The table to search in.
+ * @param i The i-value of the node.
+ * @param s The s-value of the node.
+ * @return A pointer to the node, or NULL if it does not exist.
+ */
+GraphNode* graphNodeTableFind(const GraphNodeTable* table, const uint32_t i, const uint32_t s) {
+  const uint32_t k = graphNodeTableFindIndex(table, i, s);
+
+  return k != GRAPH_NODE_TABLE_NOT_FOUND ? graphNodeTableGetNodeAt(table, k) : NULL;
+}
+
+/**
+ * Returns the position of the node (i, s) in the table, as used by graphNodeTableGetNodeAt.
+ *
+ * @param table The table to search in.
+ * @param i The i-value of the node.
+ * @param s The s-value of the node.
+ * @return The position of the node, or GRAPH_NODE_TABLE_NOT_FOUND if it does not exist.
+ */
+uint32_t graphNodeTableFindIndex(const GraphNodeTable* table, const uint32_t i, const uint32_t s) {
+  if (i == 0 || i > s || s > table->n) {
+    return GRAPH_NODE_TABLE_NOT_FOUND;
+  }
+
+  if (table->mode == GRAPH_NODE_TABLE_TRIANGULAR) {
+    return (uint32_t)graphNodeTableTriangularIndex(i, s);
+  }
+
+  const uint32_t hash = graphNodeTableHash(i, s);
+  GraphNodeTableShard* shard = graphNodeTableLockShard(table, hash);
+
+  // empty slots hold 0, which turns into GRAPH_NODE_TABLE_NOT_FOUND
+  const uint32_t slot = graphNodeTableFindSlot(table, shard->slots, shard->capacity, hash, i, s);
+  const uint32_t k = shard->slots[slot].position - 1;
+
+  graphNodeTableUnlockShard(table, shard);
+
+  return k;
+}
+
+/**
+ * Returns the largest i- and s-value of the nodes of the table.
+ *
+ * @param table The table.
+ * @return The n the table has been created with.
+ */
+uint32_t graphNodeTableGetN(const GraphNodeTable* table) {
+  return table->n;
+}
+
+/**
+ * Returns the number of nodes that exist in the table, to iterate over them with
+ * graphNodeTableGetNodeAt.
+ *
+ * @param table The table.
+ * @return The number of nodes.
+ */
+uint32_t graphNodeTableGetNNodes(const GraphNodeTable* table) {
+  return table->nNodes;
+}
+
+/**
+ * Returns the k-th existing node of the table, in no particular order.
+ *
+ * @param table The table.
+ * @param k The position of the node, less than graphNodeTableGetNNodes(table).
+ * @return A pointer to the node.
+ */
+GraphNode* graphNodeTableGetNodeAt(const GraphNodeTable* table, const uint32_t k) {
+  if (table->mode == GRAPH_NODE_TABLE_TRIANGULAR) {
+    return &(table->nodes[k]);
+  }
+
+  return graphNodeTableBlockNode(table, k);
+}
+
+/**
+ * Derives the number of outgoing edges of all nodes of the table from their incoming edges, which
+ * are the only ones recorded while the algorithm runs. Every incoming edge is recorded once, so it
+ * is counted once at its source.
+ *
+ * @param table The table whose edges should be counted.
+ * @param nOutgoing Set to the number of outgoing edges of the node at every position, needs to have
+ * graphNodeTableGetNNodes(table) entries.
+ */
+void graphNodeTableCountOutgoing(const GraphNodeTable* table, uint32_t nOutgoing[]) {
+  for (uint32_t k = 0; k < table->nNodes; k++) {
+    nOutgoing[k] = 0;
+  }
+
+  for (uint32_t k = 0; k < table->nNodes; k++) {
+    const GraphNodeStorage* incoming = graphNodeTableGetNodeAt(table, k)->incoming;
+
+    for (uint32_t e = 0; e < graphNodeStorageGetNNodes(incoming); e++) {
+      const uint32_t fromK = graphNodeTableFindIndex(table, graphNodeStorageGetI(incoming, e),
+                                                     graphNodeStorageGetS(incoming, e));
+      if (fromK != GRAPH_NODE_TABLE_NOT_FOUND) {
+        nOutgoing[fromK]++;
+      }
+    }
+  }
+}
@@ -0,0 +1,37 @@
+#ifndef GRAPH_NODE_TABLE_H
+#define GRAPH_NODE_TABLE_H
+
+#include "graphNode.h"
+#include <stdint.h>
+
+/**
+ * @brief The ways a GraphNodeTable can store its nodes.
+ */
+typedef enum GraphNodeTableMode {
+  GRAPH_NODE_TABLE_TRIANGULAR = 0, /** All nodes with i <= s, packed into a single array. */
+  GRAPH_NODE_TABLE_SPARSE = 1,     /** Only the nodes that have been accessed, found by hashing. */
+  GRAPH_NODE_TABLE_CONCURRENT = 2  /** Sparse, but safe to access from several threads at once. */
+} GraphNodeTableMode;
+
+/**
+ * @brief The GraphNodes of the dynamic program, addressed by their (i, s) values with
+ * 1 <= i <= s <= n. Nodes never move once they exist.
+ */
+typedef struct GraphNodeTable GraphNodeTable;
+
+/**
+ * The position returned by graphNodeTableFindIndex for nodes that do not exist.
+ */
+#define GRAPH_NODE_TABLE_NOT_FOUND UINT32_MAX
+
+GraphNodeTable* graphNodeTableCreate(const uint32_t n, const GraphNodeTableMode mode);
+void graphNodeTableDelete(GraphNodeTable* table);
+GraphNode* graphNodeTableGet(GraphNodeTable* table, const uint32_t i, const uint32_t s);
+GraphNode* graphNodeTableFind(const GraphNodeTable* table, const uint32_t i, const uint32_t s);
+uint32_t graphNodeTableFindIndex(const GraphNodeTable* table, const uint32_t i, const uint32_t s);
+uint32_t graphNodeTableGetN(const GraphNodeTable* table);
+uint32_t graphNodeTableGetNNodes(const GraphNodeTable* table);
+GraphNode* graphNodeTableGetNodeAt(const GraphNodeTable* table, const uint32_t k);
+void graphNodeTableCountOutgoing(const GraphNodeTable* table, uint32_t nOutgoing[]);
+
+#endif // GRAPH_NODE_TABLE_H
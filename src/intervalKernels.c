@@ -0,0 +1,304 @@
+#include "intervalKernels.h"
+#include <stdbool.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define INTERVAL_KERNELS_X86 1
+#include <immintrin.h>
+#else
+#define INTERVAL_KERNELS_X86 0
+#endif
+
+/**
+ * Function pointer types for the kernels, so the implementation can be selected at runtime.
+ */
+typedef uint32_t (*CountBoxFunc)(const IntervalColumns*, const IntervalBox);
+typedef uint32_t (*FindFirstInBoxFunc)(const IntervalColumns*, const IntervalBox);
+
+/**
+ * Returns the box containing every interval.
+ *
+ * @return The box without any restrictions.
+ */
+IntervalBox intervalBoxAll(void) { return (IntervalBox){0, UINT32_MAX, 0, UINT32_MAX}; }
+
+/**
+ * Intersects two boxes.
+ *
+ * @param a The first box.
+ * @param b The second box.
+ * @return The box containing exactly the intervals contained in both boxes.
+ */
+IntervalBox intervalBoxIntersect(const IntervalBox a, const IntervalBox b) {
+  return (IntervalBox){
+      .minBottom = a.minBottom > b.minBottom ? a.minBottom : b.minBottom,
+      .maxBottom = a.maxBottom < b.maxBottom ? a.maxBottom : b.maxBottom,
+      .minTop = a.minTop > b.minTop ? a.minTop : b.minTop,
+      .maxTop = a.maxTop < b.maxTop ? a.maxTop : b.maxTop,
+  };
+}
+
+/**
+ * Checks whether the interval at index k lies inside the box.
+ *
+ * @param columns The intervals.
+ * @param k The index of the interval.
+ * @param box The box to check against.
+ * @return true if the interval lies inside the box, false otherwise.
+ */
+static inline bool inBox(const IntervalColumns* columns, const uint32_t k, const IntervalBox box) {
+  return box.minBottom <= columns->bottoms[k] && columns->bottoms[k] <= box.maxBottom &&
+         box.minTop <= columns->tops[k] && columns->tops[k] <= box.maxTop;
+}
+
+/**
+ * Counts the intervals inside the box, starting at index start. Portable fallback and tail loop
+ * of the vectorized kernels.
+ *
+ * @param columns The intervals.
+ * @param box The box to count intervals in.
+ * @param start The index to start counting at.
+ * @return The summed amount of the intervals inside the box.
+ */
+static uint32_t countBoxScalarFrom(const IntervalColumns* columns, const IntervalBox box,
+                                   uint32_t start) {
+  uint32_t count = 0;
+
+  for (uint32_t k = start; k < columns->length; k++) {
+    if (inBox(columns, k, box)) {
+      count += columns->amounts[k];
+    }
+  }
+
+  return count;
+}
+
+/**
+ * Returns the index of the first interval inside the box, starting at index start. Portable
+ * fallback and tail loop of the vectorized kernels.
+ *
+ * @param columns The intervals.
+ * @param box The box to search in.
+ * @param start The index to start searching at.
+ * @return The index of the first interval inside the box, or columns->length if there is none.
+ */
+static uint32_t findFirstInBoxScalarFrom(const IntervalColumns* columns, const IntervalBox box,
+                                         uint32_t start) {
+  for (uint32_t k = start; k < columns->length; k++) {
+    if (inBox(columns, k, box)) {
+      return k;
+    }
+  }
+
+  return columns->length;
+}
+
+/**
+ * Portable kernel counting the intervals inside the box.
+ *
+ * @param columns The intervals.
+ * @param box The box to count intervals in.
+ * @return The summed amount of the intervals inside the box.
+ */
+static uint32_t countBoxScalar(const IntervalColumns* columns, const IntervalBox box) {
+  return countBoxScalarFrom(columns, box, 0);
+}
+
+/**
+ * Portable kernel finding the first interval inside the box.
+ *
+ * @param columns The intervals.
+ * @param box The box to search in.
+ * @return The index of the first interval inside the box, or columns->length if there is none.
+ */
+static uint32_t findFirstInBoxScalar(const IntervalColumns* columns, const IntervalBox box) {
+  return findFirstInBoxScalarFrom(columns, box, 0);
+}
+
+#if INTERVAL_KERNELS_X86
+
+/**
+ * Computes the lane mask of the intervals inside the box. Uses unsigned min/max, since there are no
+ * unsigned 32 bit comparisons before AVX-512: x >= y exactly if max(x, y) == x.
+ *
+ * @return A mask with all bits of a lane set if the interval lies inside the box.
+ */
+__attribute__((target("sse4.1"))) static inline __m128i
+inBoxSse(const __m128i bottoms, const __m128i tops, const __m128i minBottom,
+         const __m128i maxBottom, const __m128i minTop, const __m128i maxTop) {
+  __m128i mask = _mm_cmpeq_epi32(_mm_max_epu32(bottoms, minBottom), bottoms);
+  mask = _mm_and_si128(mask, _mm_cmpeq_epi32(_mm_min_epu32(bottoms, maxBottom), bottoms));
+  mask = _mm_and_si128(mask, _mm_cmpeq_epi32(_mm_max_epu32(tops, minTop), tops));
+  return _mm_and_si128(mask, _mm_cmpeq_epi32(_mm_min_epu32(tops, maxTop), tops));
+}
+
+/**
+ * SSE4.1 version of countBoxScalar, processing four intervals at a time.
+ */
+__attribute__((target("sse4.1"))) static uint32_t countBoxSse41(const IntervalColumns* columns,
+                                                                const IntervalBox box) {
+  const __m128i minBottom = _mm_set1_epi32((int32_t)box.minBottom);
+  const __m128i maxBottom = _mm_set1_epi32((int32_t)box.maxBottom);
+  const __m128i minTop = _mm_set1_epi32((int32_t)box.minTop);
+  const __m128i maxTop = _mm_set1_epi32((int32_t)box.maxTop);
+  __m128i sum = _mm_setzero_si128();
+
+  uint32_t k = 0;
+  for (; k + 4 <= columns->length; k += 4) {
+    __m128i bottoms = _mm_loadu_si128((const __m128i*)(columns->bottoms + k));
+    __m128i tops = _mm_loadu_si128((const __m128i*)(columns->tops + k));
+    __m128i amounts = _mm_loadu_si128((const __m128i*)(columns->amounts + k));
+    __m128i mask = inBoxSse(bottoms, tops, minBottom, maxBottom, minTop, maxTop);
+    sum = _mm_add_epi32(sum, _mm_and_si128(mask, amounts));
+  }
+
+  // horizontal sum of the four lanes
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+
+  return (uint32_t)_mm_cvtsi128_si32(sum) + countBoxScalarFrom(columns, box, k);
+}
+
+/**
+ * SSE4.1 version of findFirstInBoxScalar, processing four intervals at a time.
+ */
+__attribute__((target("sse4.1"))) static uint32_t
+findFirstInBoxSse41(const IntervalColumns* columns, const IntervalBox box) {
+  const __m128i minBottom = _mm_set1_epi32((int32_t)box.minBottom);
+  const __m128i maxBottom = _mm_set1_epi32((int32_t)box.maxBottom);
+  const __m128i minTop = _mm_set1_epi32((int32_t)box.minTop);
+  const __m128i maxTop = _mm_set1_epi32((int32_t)box.maxTop);
+
+  uint32_t k = 0;
+  for (; k + 4 <= columns->length; k += 4) {
+    __m128i bottoms = _mm_loadu_si128((const __m128i*)(columns->bottoms + k));
+    __m128i tops = _mm_loadu_si128((const __m128i*)(columns->tops + k));
+    __m128i mask = inBoxSse(bottoms, tops, minBottom, maxBottom, minTop, maxTop);
+    int bits = _mm_movemask_ps(_mm_castsi128_ps(mask));
+    if (bits) {
+      return k + __builtin_ctz(bits);
+    }
+  }
+
+  return findFirstInBoxScalarFrom(columns, box, k);
+}
+
+/**
+ * Computes the lane mask of the intervals inside the box, see inBoxSse.
+ *
+ * @return A mask with all bits of a lane set if the interval lies inside the box.
+ */
+__attribute__((target("avx2"))) static inline __m256i
+inBoxAvx2(const __m256i bottoms, const __m256i tops, const __m256i minBottom,
+          const __m256i maxBottom, const __m256i minTop, const __m256i maxTop) {
+  __m256i mask = _mm256_cmpeq_epi32(_mm256_max_epu32(bottoms, minBottom), bottoms);
+  mask = _mm256_and_si256(mask, _mm256_cmpeq_epi32(_mm256_min_epu32(bottoms, maxBottom), bottoms));
+  mask = _mm256_and_si256(mask, _mm256_cmpeq_epi32(_mm256_max_epu32(tops, minTop), tops));
+  return _mm256_and_si256(mask, _mm256_cmpeq_epi32(_mm256_min_epu32(tops, maxTop), tops));
+}
+
+/**
+ * AVX2 version of countBoxScalar, processing eight intervals at a time.
+ */
+__attribute__((target("avx2"))) static uint32_t countBoxAvx2(const IntervalColumns* columns,
+                                                             const IntervalBox box) {
+  const __m256i minBottom = _mm256_set1_epi32((int32_t)box.minBottom);
+  const __m256i maxBottom = _mm256_set1_epi32((int32_t)box.maxBottom);
+  const __m256i minTop = _mm256_set1_epi32((int32_t)box.minTop);
+  const __m256i maxTop = _mm256_set1_epi32((int32_t)box.maxTop);
+  __m256i sum = _mm256_setzero_si256();
+
+  uint32_t k = 0;
+  for (; k + 8 <= columns->length; k += 8) {
+    __m256i bottoms = _mm256_loadu_si256((const __m256i*)(columns->bottoms + k));
+    __m256i tops = _mm256_loadu_si256((const __m256i*)(columns->tops + k));
+    __m256i amounts = _mm256_loadu_si256((const __m256i*)(columns->amounts + k));
+    __m256i mask = inBoxAvx2(bottoms, tops, minBottom, maxBottom, minTop, maxTop);
+    sum = _mm256_add_epi32(sum, _mm256_and_si256(mask, amounts));
+  }
+
+  // horizontal sum of the eight lanes
+  __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+  half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+  half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+
+  return (uint32_t)_mm_cvtsi128_si32(half) + countBoxScalarFrom(columns, box, k);
+}
+
+/**
+ * AVX2 version of findFirstInBoxScalar, processing eight intervals at a time.
+ */
+__attribute__((target("avx2"))) static uint32_t findFirstInBoxAvx2(const IntervalColumns* columns,
+                                                                   const IntervalBox box) {
+  const __m256i minBottom = _mm256_set1_epi32((int32_t)box.minBottom);
+  const __m256i maxBottom = _mm256_set1_epi32((int32_t)box.maxBottom);
+  const __m256i minTop = _mm256_set1_epi32((int32_t)box.minTop);
+  const __m256i maxTop = _mm256_set1_epi32((int32_t)box.maxTop);
+
+  uint32_t k = 0;
+  for (; k + 8 <= columns->length; k += 8) {
+    __m256i bottoms = _mm256_loadu_si256((const __m256i*)(columns->bottoms + k));
+    __m256i tops = _mm256_loadu_si256((const __m256i*)(columns->tops + k));
+    __m256i mask = inBoxAvx2(bottoms, tops, minBottom, maxBottom, minTop, maxTop);
+    int bits = _mm256_movemask_ps(_mm256_castsi256_ps(mask));
+    if (bits) {
+      return k + __builtin_ctz(bits);
+    }
+  }
+
+  return findFirstInBoxScalarFrom(columns, box, k);
+}
+
+#endif // INTERVAL_KERNELS_X86
+
+// the selected kernels, the scalar ones are used until the CPU has been inspected
+static CountBoxFunc countBoxImpl = countBoxScalar;
+static FindFirstInBoxFunc findFirstInBoxImpl = findFirstInBoxScalar;
+static const char* kernelName = "scalar";
+
+/**
+ * Selects the widest kernels the CPU supports. Runs once before main.
+ */
+__attribute__((constructor)) static void intervalKernelsSelect(void) {
+#if INTERVAL_KERNELS_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx2")) {
+    countBoxImpl = countBoxAvx2;
+    findFirstInBoxImpl = findFirstInBoxAvx2;
+    kernelName = "avx2";
+  } else if (__builtin_cpu_supports("sse4.1")) {
+    countBoxImpl = countBoxSse41;
+    findFirstInBoxImpl = findFirstInBoxSse41;
+    kernelName = "sse4.1";
+  }
+#endif
+}
+
+/**
+ * Counts the intervals inside the given box, weighted by their amounts.
+ *
+ * @param columns The intervals to count.
+ * @param box The box to count the intervals in.
+ * @return The summed amount of all intervals inside the box.
+ */
+uint32_t intervalKernelCountBox(const IntervalColumns* columns, const IntervalBox box) {
+  return countBoxImpl(columns, box);
+}
+
+/**
+ * Returns the index of the first interval inside the given box.
+ *
+ * @param columns The intervals to search in.
+ * @param box The box to search in.
+ * @return The index of the first interval inside the box, or columns->length if there is none.
+ */
+uint32_t intervalKernelFindFirstInBox(const IntervalColumns* columns, const IntervalBox box) {
+  return findFirstInBoxImpl(columns, box);
+}
+
+/**
+ * Returns the name of the selected kernel implementation, for logging.
+ *
+ * @return The name of the instruction set the kernels use.
+ */
+const char* intervalKernelGetName(void) { return kernelName; }
@@ -0,0 +1,35 @@
+#ifndef INTERVAL_KERNELS_H
+#define INTERVAL_KERNELS_H
+
+#include <stdint.h>
+
+/**
+ * @brief A rectangle of (bottom, top) values, all bounds are inclusive.
+ *
+ * Every counting query on interval sets can be phrased as counting the intervals inside such a box,
+ * e.g. the intervals containing i are those with bottom in [0, i] and top in [i, UINT32_MAX].
+ */
+typedef struct IntervalBox {
+  uint32_t minBottom; /** The minimal bottom value. */
+  uint32_t maxBottom; /** The maximal bottom value. */
+  uint32_t minTop;    /** The minimal top value. */
+  uint32_t maxTop;    /** The maximal top value. */
+} IntervalBox;
+
+/**
+ * @brief Intervals stored as structure of arrays.
+ */
+typedef struct IntervalColumns {
+  const uint32_t* bottoms; /** The bottom values of the intervals. */
+  const uint32_t* tops;    /** The top values of the intervals. */
+  const uint32_t* amounts; /** The amounts of the intervals. */
+  uint32_t length;         /** The number of intervals. */
+} IntervalColumns;
+
+IntervalBox intervalBoxAll(void);
+IntervalBox intervalBoxIntersect(const IntervalBox a, const IntervalBox b);
+uint32_t intervalKernelCountBox(const IntervalColumns* columns, const IntervalBox box);
+uint32_t intervalKernelFindFirstInBox(const IntervalColumns* columns, const IntervalBox box);
+const char* intervalKernelGetName(void);
+
+#endif // INTERVAL_KERNELS_H
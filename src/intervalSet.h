@@ -7,31 +7,79 @@
 
 struct StackNode;
 typedef struct StackNode* Stack;
+typedef struct IntervalSetIndex IntervalSetIndex;
+
+/**
+ * Summary of the bottom values of an IntervalSet. If a set is dominated by another one, each of
+ * these values is at most as large for the dominating set, which rejects most pairs in O(1).
+ */
+typedef struct IntervalSetFingerprint {
+  uint32_t minBottom; /** The smallest bottom value, 0 for empty sets */
+  uint32_t maxBottom; /** The largest bottom value, 0 for empty sets */
+  uint64_t bottomSum; /** The sum of all bottom values, weighted by their amounts */
+} IntervalSetFingerprint;
 
 /**
  * The IntervalSet struct intervalContains a stack of GraphNodes, the length of the interval set,
- * and an array of Interval structs.
+ * and its intervals stored as structure of arrays, so counting loops can be vectorized.
  */
 typedef struct IntervalSet {
   Stack stack;     /** The stack of the set */
+  uint32_t id;     /** The unique id of the set, assigned at creation */
   uint32_t length; /** The length of the interval set (measured in how many distinct intervals it
                       contains) */
-  Interval intervals[]; /** The array of Interval structs */
+  bool sorted;         /** Whether the intervals are sorted by bottom in descending order */
+  uint32_t nIntervals; /** The number of intervals, i.e. the sum of all amounts */
+  IntervalSetFingerprint fingerprint; /** Summary of the bottom values for dominance checks */
+  IntervalSetIndex* index; /** Sorted prefix counts, built on first use, NULL for short sets */
+  uint32_t* bottoms;       /** The bottom values of the intervals */
+  uint32_t* tops;          /** The top values of the intervals */
+  uint32_t* amounts;       /** The amounts of the intervals */
+  uint32_t data[];         /** The memory backing the three columns */
 } IntervalSet;
 
+/**
+ * A non-owning view onto an IntervalSet that only exposes the intervals matching a filter, or, if
+ * inverse is set, the intervals not matching it. Views are cheap to create and must not outlive
+ * the viewed set.
+ */
+typedef struct IntervalSetView {
+  const IntervalSet* base; /** The viewed IntervalSet */
+  uint32_t topBelow;       /** Only intervals with a top value less than this match */
+  uint32_t minBottom;      /** Only intervals with a bottom value of at least this match */
+  uint32_t minTop;         /** Only intervals with a top value of at least this match */
+  bool inverse;            /** Whether the view exposes the non-matching intervals instead */
+} IntervalSetView;
+
+/**
+ * The outcomes of building a group from the lowest part of an IntervalSet.
+ */
+typedef enum IntervalSetAssignStatus {
+  INTERVAL_SET_ASSIGNED = 0,       /** The group has been built. */
+  INTERVAL_SET_ASSIGN_TOO_FEW = 1, /** Too few intervals contain the group size. */
+  INTERVAL_SET_ASSIGN_INVALID = 2  /** An interval lies above the group size. */
+} IntervalSetAssignStatus;
+
 IntervalSet* intervalSetCreateBlank(const Interval intervals[], const uint32_t length);
 void intervalSetDelete(IntervalSet* intervalSet);
+Interval intervalSetGetInterval(const IntervalSet* intervalSet, const uint32_t k);
 bool intervalSetIsDominatedBy(const IntervalSet* thisSet, const IntervalSet* otherSet);
 void intervalSetSortByBottom(IntervalSet* intervalSet);
+void intervalSetNormalize(IntervalSet* intervalSet);
 void intervalSetPrint(const IntervalSet* intervalSet);
 uint32_t intervalSetCountGreaterI(const IntervalSet* intervalSet, const uint32_t i);
 uint32_t intervalSetCountContainingI(const IntervalSet* intervalSet, const uint32_t i);
-IntervalSet* intervalSetGetWithoutFirstGIncludingI(const IntervalSet* intervalSet, const uint32_t i,
+IntervalSetView intervalSetViewWhole(const IntervalSet* intervalSet);
+uint32_t intervalSetViewCountGreaterI(const IntervalSetView* view, const uint32_t i);
+uint32_t intervalSetViewCountContainingI(const IntervalSetView* view, const uint32_t i);
+IntervalSet* intervalSetGetWithoutFirstGIncludingI(const IntervalSetView* view, const uint32_t i,
                                                    uint32_t g);
-IntervalSet* intervalSetGetLowestPart(IntervalSet* intervalSet);
-uint32_t intervalSetCountLowestPartGreaterEqualJ(IntervalSet* intervalSet, const uint32_t j);
-IntervalSet* intervalSetGetInverseLowestPartGreaterEqualJ(IntervalSet* intervalSet,
-                                                          const uint32_t j);
+IntervalSetView intervalSetGetLowestPart(const IntervalSet* intervalSet);
+IntervalSet* intervalSetAssignLowestPart(const IntervalSet* intervalSet, const uint32_t g,
+                                         IntervalSetAssignStatus* status);
+uint32_t intervalSetCountLowestPartGreaterEqualJ(const IntervalSet* intervalSet, const uint32_t j);
+IntervalSetView intervalSetGetInverseLowestPartGreaterEqualJ(const IntervalSet* intervalSet,
+                                                             const uint32_t j);
 uint32_t intervalSetCountIntervals(const IntervalSet* intervalSet);
 
 #endif // INTERVAL_SET_H
\ No newline at end of file
@@ -26,11 +26,12 @@ void runInfoDelete(RunInfo* runInfo) {
 static void addRunInfoToJson(RunInfo* runInfo, json_object* jobj) {
   json_object_object_add(jobj, "description", json_object_new_string(runInfo->description));
   json_object_object_add(jobj, "solutionFound", json_object_new_boolean(runInfo->solutionFound));
+  json_object_object_add(jobj, "failed", json_object_new_boolean(runInfo->failed));
   json_object_object_add(jobj, "nIntervals", json_object_new_int(runInfo->nIntervals));
-  json_object_object_add(jobj, "nGroupsBuilt", json_object_new_int(runInfo->nGroupsBuilt));
-  json_object_object_add(jobj, "nGroupsKept", json_object_new_int(runInfo->nGroupsKept));
+  json_object_object_add(jobj, "nGroupsBuilt", json_object_new_int64(runInfo->nGroupsBuilt));
+  json_object_object_add(jobj, "nGroupsKept", json_object_new_int64(runInfo->nGroupsKept));
   json_object_object_add(jobj, "nSolutions", json_object_new_int(runInfo->nSolutions));
-  json_object_object_add(jobj, "nSteps", json_object_new_int(runInfo->nSteps));
+  json_object_object_add(jobj, "nSteps", json_object_new_int64(runInfo->nSteps));
   json_object_object_add(jobj, "nUsedNodes", json_object_new_int(runInfo->nUsedNodes));
   json_object_object_add(jobj, "avgOutgoingEdges",
                          json_object_new_double(runInfo->avgOutgoingEdges));
@@ -9,11 +9,12 @@
 typedef struct RunInfo {
   char description[RUN_INFO_DESC_LENGTH];
   bool solutionFound;
+  bool failed;
   uint32_t nIntervals;
-  uint32_t nGroupsBuilt;
-  uint32_t nGroupsKept;
+  uint64_t nGroupsBuilt;
+  uint64_t nGroupsKept;
   uint32_t nSolutions;
-  uint32_t nSteps;
+  uint64_t nSteps;
   uint32_t nUsedNodes;
   double avgOutgoingEdges;
   double avgIncomingEdges;
@@ -2,26 +2,52 @@
 #define DEBUG_PRINT 1
 #include "debug.h"
 #include "instanceGen.h"
+#include "intervalKernels.h"
 #include "test.h"
 #include <omp.h>
 #include <stdlib.h>
+#include <string.h>
 
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 int main(int argc, char** argv) {
-  if (argc != 2) {
-    printf("Usage: ./badMemAlg <n_intervals>\n");
-    return 1;
+  // the switches precede the number of intervals: --solve-only skips the metrics and stops as
+  // soon as the decision is known, --release-marks frees the marks of finished nodes and
+  // --visit-by-key visits the sets of a predecessor by descending key instead of newest first
+  BadMemAlgOptions options = badMemAlgGetOptions();
+  int arg = 1;
+  for (; arg < argc - 1; arg++) {
+    if (strcmp(argv[arg], "--solve-only") == 0) {
+      options.solveOnly = true;
+    } else if (strcmp(argv[arg], "--release-marks") == 0) {
+      options.releaseMarks = true;
+    } else if (strcmp(argv[arg], "--visit-by-key") == 0) {
+      options.visitByKey = true;
+    } else {
+      break;
+    }
   }
 
-  const uint32_t N_INTERVALS = atoi(argv[1]);
+  const uint32_t N_INTERVALS = arg == argc - 1 ? atoi(argv[arg]) : 0;
+  if (N_INTERVALS == 0) {
+    printf("Usage: ./badMemAlg [--solve-only] [--release-marks] [--visit-by-key] <n_intervals>\n");
+    return 1;
+  }
+  badMemAlgSetOptions(options);
 
   // log the number of threads
   printf("Max number of threads: %d\n", omp_get_max_threads());
+  printf("Interval kernels: %s\n", intervalKernelGetName());
+  printf("Solve only: %s\n", options.solveOnly ? "yes" : "no");
+  printf("Release marks: %s\n", options.releaseMarks ? "yes" : "no");
+  printf("Visit by key: %s\n", options.visitByKey ? "yes" : "no");
 
   testRunAllParallelized(N_INTERVALS);
   testRunAll(N_INTERVALS);
+  testRunAllFrontier(N_INTERVALS);
+  testReleaseMarks(N_INTERVALS);
   testSameSimpleInstances(N_INTERVALS, 20);
   testRunAllDepthFirst(N_INTERVALS);
+  testRunAllDepthFirstParallel(N_INTERVALS);
   // testAmountInstances(N_INTERVALS);
 
   printf("Done.\n");
@@ -1,21 +1,84 @@
 #include "markStorage.h"
 #include "debug.h"
+#include "intervalSet.h"
+#include "memArena.h"
 #include <stdlib.h>
 
 /**
- * Adds an IntervalSet to the MarkStorage.
+ * The number of slots allocated for the first marked IntervalSet, must be a power of two.
+ */
+#define MARK_STORAGE_INITIAL_CAPACITY 8
+
+/**
+ * Finds the slot of the given id, or the empty slot where it would have to be inserted.
+ *
+ * @param slots The slots of the hash set.
+ * @param capacity The number of slots, a power of two.
+ * @param id The id to search for.
+ * @return The position of the slot.
+ */
+static uint32_t markStorageFindSlot(const uint32_t slots[], const uint32_t capacity,
+                                    const uint32_t id) {
+  uint32_t slot = (id * 0x9E3779B1u) & (capacity - 1);
+
+  while (slots[slot] && slots[slot] != id) {
+    slot = (slot + 1) & (capacity - 1);
+  }
+
+  return slot;
+}
+
+/**
+ * Doubles the number of slots of the MarkStorage (or allocates them initially) and reinserts all
+ * ids.
+ *
+ * @param markStorage The MarkStorage to grow.
+ * @return True if the MarkStorage has been grown, false if memory allocation fails.
+ */
+static bool markStorageGrow(MarkStorage* markStorage) {
+  const uint32_t capacity =
+      markStorage->capacity ? 2 * markStorage->capacity : MARK_STORAGE_INITIAL_CAPACITY;
+  uint32_t* slots = memAlloc(sizeof(uint32_t) * capacity);
+
+  if (!slots) {
+    return false;
+  }
+
+  for (uint32_t slot = 0; slot < capacity; slot++) {
+    slots[slot] = 0;
+  }
+  for (uint32_t slot = 0; slot < markStorage->capacity; slot++) {
+    const uint32_t id = markStorage->slots[slot];
+    if (id) {
+      slots[markStorageFindSlot(slots, capacity, id)] = id;
+    }
+  }
+
+  memFree(markStorage->slots);
+  markStorage->slots = slots;
+  markStorage->capacity = capacity;
+
+  return true;
+}
+
+/**
+ * Adds an IntervalSet to the MarkStorage, if it is not marked already.
  *
  * @param markStorage The MarkStorage to add the IntervalSet to.
  * @param intervalSet The IntervalSet to be added.
  */
 void markStorageAddSet(MarkStorage* markStorage, IntervalSet* intervalSet) {
   if (intervalSet) {
-    MarkNode* markNode = malloc(sizeof(MarkNode));
-
-    markNode->intervalSet = intervalSet;
-    markNode->next = *markStorage;
+    // keep the load factor at most one half
+    if (2 * (markStorage->length + 1) > markStorage->capacity && !markStorageGrow(markStorage)) {
+      return;
+    }
 
-    *markStorage = markNode;
+    uint32_t slot = markStorageFindSlot(markStorage->slots, markStorage->capacity, intervalSet->id);
+    if (!markStorage->slots[slot]) {
+      markStorage->slots[slot] = intervalSet->id;
+      markStorage->length++;
+    }
   }
 }
 
@@ -27,18 +90,25 @@ void markStorageAddSet(MarkStorage* markStorage, IntervalSet* intervalSet) {
  */
 void markStorageDelete(MarkStorage* markStorage) {
   if (markStorage) {
-    MarkNode* currNode = *markStorage;
+    memFree(markStorage->slots);
 
-    while (currNode) {
-      MarkNode* nextNode = currNode->next;
-      free(currNode);
-      currNode = nextNode;
-    }
-
-    *markStorage = NULL;
+    *markStorage = (MarkStorage){0};
   }
 }
 
+/**
+ * Frees the memory of a MarkStorage but keeps the number of marked IntervalSets, so it can still
+ * be counted. No IntervalSets may be marked or checked in it afterwards.
+ *
+ * @param markStorage A pointer to the MarkStorage to be released.
+ */
+void markStorageRelease(MarkStorage* markStorage) {
+  memFree(markStorage->slots);
+
+  markStorage->slots = NULL;
+  markStorage->capacity = 0;
+}
+
 /**
  * Checks if a given interval set is marked in the mark storage.
  *
@@ -47,16 +117,14 @@ void markStorageDelete(MarkStorage* markStorage) {
  * @return True if the interval set is marked, false otherwise.
  */
 bool markStorageIsMarked(MarkStorage* markStorage, IntervalSet* intervalSet) {
-  MarkNode* currNode = *markStorage;
-
-  while (currNode) {
-    if (currNode->intervalSet == intervalSet) {
-      return true;
-    }
-    currNode = currNode->next;
+  if (markStorage->capacity == 0) {
+    return false;
   }
 
-  return false;
+  const uint32_t slot =
+      markStorageFindSlot(markStorage->slots, markStorage->capacity, intervalSet->id);
+
+  return markStorage->slots[slot] == intervalSet->id;
 }
 
 /**
@@ -66,15 +134,7 @@ bool markStorageIsMarked(MarkStorage* markStorage, IntervalSet* intervalSet) {
  * @return The number of marked interval sets.
  */
 uint32_t markStorageCount(MarkStorage* markStorage) {
-  uint32_t count = 0;
-  MarkNode* currNode = *markStorage;
-
-  while (currNode) {
-    count++;
-    currNode = currNode->next;
-  }
-
-  return count;
+  return markStorage->length;
 }
 
 /**
@@ -83,10 +143,9 @@ uint32_t markStorageCount(MarkStorage* markStorage) {
  * @param markStorage The mark storage to print.
  */
 void markStoragePrint(const MarkStorage* markStorage) {
-  MarkNode* currNode = *markStorage;
-
-  while (currNode) {
-    printf("Pointer to interval set: %p\n", (void*)currNode->intervalSet);
-    currNode = currNode->next;
+  for (uint32_t slot = 0; slot < markStorage->capacity; slot++) {
+    if (markStorage->slots[slot]) {
+      printf("Id of interval set: %u\n", markStorage->slots[slot]);
+    }
   }
-}
\ No newline at end of file
+}
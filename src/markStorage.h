@@ -1,22 +1,26 @@
 #ifndef MARK_STORAGE_H
 #define MARK_STORAGE_H
 
-#include "intervalSet.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef struct IntervalSet IntervalSet;
 
-typedef struct MarkNode {
-  IntervalSet* intervalSet;
-  struct MarkNode* next;
-} MarkNode;
-
-typedef MarkNode* MarkStorage;
+/**
+ * @brief The set of IntervalSets marked in a GraphNode, stored as an open addressing hash set of
+ * their ids. An empty MarkStorage has no memory allocated.
+ */
+typedef struct MarkStorage {
+  uint32_t* slots;   /** The ids of the marked IntervalSets, 0 marks an empty slot. */
+  uint32_t length;   /** The number of marked IntervalSets. */
+  uint32_t capacity; /** The number of slots, a power of two or 0. */
+} MarkStorage;
 
 void markStorageAddSet(MarkStorage* markStorage, IntervalSet* intervalSet);
 void markStorageDelete(MarkStorage* markStorage);
+void markStorageRelease(MarkStorage* markStorage);
 bool markStorageIsMarked(MarkStorage* markStorage, IntervalSet* intervalSet);
 uint32_t markStorageCount(MarkStorage* markStorage);
 void markStoragePrint(const MarkStorage* markStorage);
 
-#endif // MARK_STORAGE_H
\ No newline at end of file
+#endif // MARK_STORAGE_H
@@ -0,0 +1,325 @@
+#include "memArena.h"
+#include <omp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The size of the slabs the per-thread arenas bump-allocate from. Blocks larger than a quarter of
+ * it get a slab of their own.
+ */
+#define MEM_CHUNK_SIZE ((size_t)1 << 20)
+
+/**
+ * Blocks up to MEM_SMALL_STEP * MEM_SMALL_CLASSES bytes are rounded up to a multiple of
+ * MEM_SMALL_STEP, larger ones to a power of two.
+ */
+#define MEM_SMALL_STEP 16
+#define MEM_SMALL_CLASSES 64
+#define MEM_N_CLASSES (MEM_SMALL_CLASSES + 48)
+
+/**
+ * The size class stored in the header of blocks that have been allocated by malloc.
+ */
+#define MEM_FROM_MALLOC SIZE_MAX
+
+/**
+ * @brief The header in front of every block handed out.
+ */
+typedef struct MemHeader {
+  size_t sizeClass; /** The size class of the block, or MEM_FROM_MALLOC. */
+} MemHeader;
+
+/**
+ * @brief A freed arena block, linked into the free list of its size class.
+ */
+typedef struct MemFreeBlock {
+  struct MemFreeBlock* next; /** The next free block of the same size class. */
+} MemFreeBlock;
+
+/**
+ * @brief A slab of memory obtained from malloc. The blocks follow directly after it.
+ */
+typedef struct MemChunk {
+  struct MemChunk* next; /** The previously allocated slab of the same arena. */
+} MemChunk;
+
+/**
+ * @brief The memory of the arena owned by one thread.
+ */
+typedef struct MemThreadArena {
+  MemChunk* chunks;                       /** All slabs of this arena. */
+  char* start;                            /** The start of the current slab. */
+  char* bump;                             /** The next unused byte of the current slab. */
+  char* end;                              /** The end of the current slab. */
+  MemFreeBlock* freeLists[MEM_N_CLASSES]; /** The freed blocks of every size class. */
+} MemThreadArena;
+
+// the per-thread arenas of the active run, followed by one arena shared by all other threads
+static MemThreadArena* threadArenas = NULL;
+static int nThreadArenas = 0;
+
+/**
+ * Returns the size in bytes of the blocks of the given size class, including their header.
+ *
+ * @param sizeClass The size class.
+ * @return The size of the blocks.
+ */
+static size_t memClassSize(const size_t sizeClass) {
+  if (sizeClass < MEM_SMALL_CLASSES) {
+    return MEM_SMALL_STEP * (sizeClass + 1);
+  }
+
+  return ((size_t)MEM_SMALL_STEP * MEM_SMALL_CLASSES) << (sizeClass - MEM_SMALL_CLASSES + 1);
+}
+
+/**
+ * Returns the smallest size class whose blocks can hold the given number of bytes.
+ *
+ * @param blockSize The number of bytes needed, including the header.
+ * @return The size class, MEM_N_CLASSES if the size is too large for the arena.
+ */
+static size_t memSizeClass(const size_t blockSize) {
+  if (blockSize <= MEM_SMALL_STEP * MEM_SMALL_CLASSES) {
+    return (blockSize + MEM_SMALL_STEP - 1) / MEM_SMALL_STEP - 1;
+  }
+
+  size_t sizeClass = MEM_SMALL_CLASSES;
+  while (sizeClass < MEM_N_CLASSES && memClassSize(sizeClass) < blockSize) {
+    sizeClass++;
+  }
+
+  return sizeClass;
+}
+
+/**
+ * Returns the index of the arena the calling thread may use without synchronization. Threads of
+ * nested parallel regions, or beyond the team size the arena was set up for, get the index of the
+ * shared arena.
+ *
+ * @return The index into threadArenas.
+ */
+static int memArenaThreadIndex(void) {
+  const int thread = omp_get_level() > 1 ? nThreadArenas : omp_get_thread_num();
+
+  return thread < nThreadArenas ? thread : nThreadArenas;
+}
+
+/**
+ * Takes a block of the given size class from the free list of the arena, or bump-allocates it
+ * from the current slab, starting a new slab if needed.
+ *
+ * @param arena The arena to allocate from.
+ * @param sizeClass The size class of the block.
+ * @return A pointer to the usable memory of the block, or NULL if memory allocation fails.
+ */
+static void* memArenaAllocate(MemThreadArena* arena, const size_t sizeClass) {
+  MemFreeBlock* freeBlock = arena->freeLists[sizeClass];
+  if (freeBlock) {
+    arena->freeLists[sizeClass] = freeBlock->next;
+    return freeBlock;
+  }
+
+  const size_t blockSize = memClassSize(sizeClass);
+  MemHeader* header;
+
+  if ((size_t)(arena->end - arena->bump) >= blockSize) {
+    header = (MemHeader*)arena->bump;
+    arena->bump += blockSize;
+  } else {
+    const bool dedicated = blockSize > MEM_CHUNK_SIZE / 4;
+    MemChunk* chunk = malloc(sizeof(MemChunk) + (dedicated ? blockSize : MEM_CHUNK_SIZE));
+
+    if (!chunk) {
+      return NULL;
+    }
+
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    header = (MemHeader*)(chunk + 1);
+
+    // large blocks do not replace the current slab, which likely still has room left
+    if (!dedicated) {
+      arena->start = (char*)header;
+      arena->bump = arena->start + blockSize;
+      arena->end = arena->start + MEM_CHUNK_SIZE;
+    }
+  }
+
+  header->sizeClass = sizeClass;
+
+  return header + 1;
+}
+
+/**
+ * Starts a run-scoped arena. Until memArenaEnd is called, memAlloc hands out memory from it.
+ * Arenas cannot be nested and have to be started outside of parallel regions.
+ *
+ * @return True if the arena is active, false if memory allocation failed and memAlloc keeps
+ * using malloc.
+ */
+bool memArenaBegin(void) {
+  if (threadArenas) {
+    return true;
+  }
+
+  const int nThreads = omp_get_max_threads();
+  threadArenas = calloc(nThreads + 1, sizeof(MemThreadArena));
+  nThreadArenas = threadArenas ? nThreads : 0;
+
+  return threadArenas != NULL;
+}
+
+/**
+ * Ends the active arena and releases all memory allocated from it, including blocks that have
+ * not been freed. Has to be called outside of parallel regions.
+ */
+void memArenaEnd(void) {
+  if (!threadArenas) {
+    return;
+  }
+
+  for (int t = 0; t <= nThreadArenas; t++) {
+    MemChunk* chunk = threadArenas[t].chunks;
+    while (chunk) {
+      MemChunk* next = chunk->next;
+      free(chunk);
+      chunk = next;
+    }
+  }
+
+  free(threadArenas);
+  threadArenas = NULL;
+  nThreadArenas = 0;
+}
+
+/**
+ * Checks whether an arena is active, i.e. whether memory allocated now is released by
+ * memArenaEnd.
+ *
+ * @return True if an arena is active, false otherwise.
+ */
+bool memArenaIsActive(void) {
+  return threadArenas != NULL;
+}
+
+/**
+ * Allocates memory, from the active arena if there is one and from malloc otherwise. The memory
+ * is aligned to at least eight bytes.
+ *
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, or NULL if memory allocation fails.
+ */
+void* memAlloc(const size_t size) {
+  const size_t sizeClass = memSizeClass(sizeof(MemHeader) + size);
+
+  if (threadArenas && sizeClass < MEM_N_CLASSES) {
+    const int thread = memArenaThreadIndex();
+
+    if (thread < nThreadArenas) {
+      return memArenaAllocate(&threadArenas[thread], sizeClass);
+    }
+
+    void* ptr;
+#pragma omp critical(memArenaShared)
+    ptr = memArenaAllocate(&threadArenas[thread], sizeClass);
+    return ptr;
+  }
+
+  MemHeader* header = malloc(sizeof(MemHeader) + size);
+  if (!header) {
+    return NULL;
+  }
+  header->sizeClass = MEM_FROM_MALLOC;
+
+  return header + 1;
+}
+
+/**
+ * Resizes memory obtained from memAlloc. Shrinking an arena block keeps it in place and gives the
+ * memory back if it is the most recent block of the calling thread's slab.
+ *
+ * @param ptr The memory to resize, may be NULL.
+ * @param size The new size in bytes.
+ * @return A pointer to the resized memory, or NULL if memory allocation fails, in which case ptr
+ * is left untouched.
+ */
+void* memRealloc(void* ptr, const size_t size) {
+  if (!ptr) {
+    return memAlloc(size);
+  }
+
+  MemHeader* header = (MemHeader*)ptr - 1;
+
+  if (header->sizeClass == MEM_FROM_MALLOC) {
+    MemHeader* moved = realloc(header, sizeof(MemHeader) + size);
+    return moved ? moved + 1 : NULL;
+  }
+
+  const size_t sizeClass = memSizeClass(sizeof(MemHeader) + size);
+  const size_t oldBlockSize = memClassSize(header->sizeClass);
+
+  if (sizeClass <= header->sizeClass) {
+    const int thread = memArenaThreadIndex();
+
+    if (thread < nThreadArenas) {
+      MemThreadArena* arena = &threadArenas[thread];
+      char* block = (char*)header;
+
+      if (block >= arena->start && block + oldBlockSize == arena->bump) {
+        arena->bump = block + memClassSize(sizeClass);
+        header->sizeClass = sizeClass;
+      }
+    }
+
+    return ptr;
+  }
+
+  void* moved = memAlloc(size);
+  if (moved) {
+    memcpy(moved, ptr, oldBlockSize - sizeof(MemHeader));
+    memFree(ptr);
+  }
+
+  return moved;
+}
+
+/**
+ * Frees memory obtained from memAlloc. Arena blocks are kept for reuse by the calling thread until
+ * the arena ends. They must not outlive memArenaEnd, which releases them along with their slabs,
+ * so they have to be freed before it if at all.
+ *
+ * @param ptr The memory to free, may be NULL.
+ */
+void memFree(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+
+  MemHeader* header = (MemHeader*)ptr - 1;
+
+  if (header->sizeClass == MEM_FROM_MALLOC) {
+    free(header);
+    return;
+  }
+
+  // an arena block without an active arena has outlived memArenaEnd, its memory is gone already
+  if (!threadArenas) {
+    return;
+  }
+
+  MemFreeBlock* freeBlock = ptr;
+  const int thread = memArenaThreadIndex();
+  MemThreadArena* arena = &threadArenas[thread];
+
+  if (thread < nThreadArenas) {
+    freeBlock->next = arena->freeLists[header->sizeClass];
+    arena->freeLists[header->sizeClass] = freeBlock;
+  } else {
+#pragma omp critical(memArenaShared)
+    {
+      freeBlock->next = arena->freeLists[header->sizeClass];
+      arena->freeLists[header->sizeClass] = freeBlock;
+    }
+  }
+}
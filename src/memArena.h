@@ -0,0 +1,25 @@
+#ifndef MEM_ARENA_H
+#define MEM_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Run-scoped memory for the many small objects of the bad memory algorithm.
+ *
+ * While an arena is active, memAlloc bump-allocates from per-thread slabs and memFree puts blocks
+ * on per-thread free lists for reuse, so neither takes a lock or calls into malloc in the common
+ * case. memArenaEnd releases all blocks of the run at once, objects allocated from the arena must
+ * not be used, freed or resized afterwards. Without an active arena, the functions fall back to
+ * malloc and free. Every block remembers where it came from, so memFree and memRealloc accept both
+ * kinds.
+ */
+
+bool memArenaBegin(void);
+void memArenaEnd(void);
+bool memArenaIsActive(void);
+void* memAlloc(const size_t size);
+void* memRealloc(void* ptr, const size_t size);
+void memFree(void* ptr);
+
+#endif // MEM_ARENA_H
@@ -1,7 +1,212 @@
 #include "stack.h"
 #include "debug.h"
+#include "memArena.h"
+#include <omp.h>
 #include <stdlib.h>
 
+/**
+ * The initial capacity of the intern table of a shard, must be a power of two.
+ */
+#define STACK_INTERN_INITIAL_CAPACITY 64
+
+/**
+ * The intern table is split into 2^STACK_INTERN_SHARD_BITS shards, each with a lock of its own,
+ * so concurrent pushes only contend if their keys hash to the same shard.
+ */
+#define STACK_INTERN_SHARD_BITS 6
+#define STACK_INTERN_N_SHARDS (1u << STACK_INTERN_SHARD_BITS)
+
+/**
+ * An entry of the intern table, mapping a (top value, id of the rest of the stack) pair to the id
+ * of the whole stack.
+ */
+typedef struct StackInternEntry {
+  GraphNode* value;  /** The top value of the stack, NULL marks an empty slot. */
+  uint32_t parentId; /** The id of the stack below the top value. */
+  uint32_t id;       /** The id of the stack. */
+} StackInternEntry;
+
+/**
+ * @brief A shard of the intern table, holding the keys whose hash selects it. Padded to a cache
+ * line, so the locks of different shards do not share one.
+ */
+typedef struct StackInternShard {
+  StackInternEntry* table; /** The open addressing hash table of the shard. */
+  uint32_t capacity;       /** The capacity of the table, a power of two or 0. */
+  uint32_t size;           /** The number of entries in the table. */
+  omp_lock_t lock;         /** Guards the table, capacity and size. */
+} __attribute__((aligned(64))) StackInternShard;
+
+/**
+ * Global hash table interning all stacks, so equal stacks get equal ids. The empty stack has id 0.
+ * The locks of the shards are initialized on first use and never destroyed.
+ */
+static StackInternShard internShards[STACK_INTERN_N_SHARDS];
+static bool internLocksInitialized = false;
+
+/**
+ * Computes the hash of an intern table key.
+ *
+ * @param value The top value of the stack.
+ * @param parentId The id of the stack below the top value.
+ * @return The hash of the key.
+ */
+static uint64_t stackInternHash(const GraphNode* value, const uint32_t parentId) {
+  uint64_t hash = (uint64_t)(uintptr_t)value * 0x9E3779B97F4A7C15ULL;
+  hash ^= (uint64_t)parentId * 0xC2B2AE3D27D4EB4FULL;
+
+  return hash ^ (hash >> 29);
+}
+
+/**
+ * Finds the slot of the given key in an intern table, or the empty slot it would be inserted at.
+ *
+ * @param table The intern table to search in.
+ * @param capacity The capacity of the table.
+ * @param hash The hash of the key.
+ * @param value The top value of the stack.
+ * @param parentId The id of the stack below the top value.
+ * @return A pointer to the slot.
+ */
+static StackInternEntry* stackInternFindSlot(StackInternEntry table[], const uint32_t capacity,
+                                             const uint64_t hash, const GraphNode* value,
+                                             const uint32_t parentId) {
+  uint32_t slot = hash & (capacity - 1);
+
+  while (table[slot].value && (table[slot].value != value || table[slot].parentId != parentId)) {
+    slot = (slot + 1) & (capacity - 1);
+  }
+
+  return &(table[slot]);
+}
+
+/**
+ * Doubles the capacity of the table of a shard (or allocates it initially) and rehashes all its
+ * entries. The lock of the shard has to be held.
+ *
+ * @param shard The shard to grow.
+ */
+static void stackInternGrow(StackInternShard* shard) {
+  uint32_t newCapacity = shard->capacity ? 2 * shard->capacity : STACK_INTERN_INITIAL_CAPACITY;
+  StackInternEntry* newTable = calloc(newCapacity, sizeof(StackInternEntry));
+
+  for (uint32_t k = 0; k < shard->capacity; k++) {
+    const StackInternEntry* entry = &(shard->table[k]);
+    if (entry->value) {
+      const uint64_t hash = stackInternHash(entry->value, entry->parentId);
+      *stackInternFindSlot(newTable, newCapacity, hash, entry->value, entry->parentId) = *entry;
+    }
+  }
+
+  free(shard->table);
+  shard->table = newTable;
+  shard->capacity = newCapacity;
+}
+
+/**
+ * Initializes the locks of the shards, unless that has happened already.
+ */
+static void stackInternInitLocks(void) {
+  bool initialized;
+#pragma omp atomic read
+  initialized = internLocksInitialized;
+
+  if (!initialized) {
+#pragma omp critical(stackInternInit)
+    if (!internLocksInitialized) {
+      for (uint32_t k = 0; k < STACK_INTERN_N_SHARDS; k++) {
+        omp_init_lock(&(internShards[k].lock));
+      }
+#pragma omp atomic write
+      internLocksInitialized = true;
+    }
+  }
+}
+
+/**
+ * Returns the interned id of the stack consisting of value on top of the stack with parentId. The
+ * ids are made unique across the shards by storing the shard in their low bits.
+ *
+ * @param value The top value of the stack.
+ * @param parentId The id of the stack below the top value.
+ * @return The id of the stack.
+ */
+static uint32_t stackIntern(GraphNode* value, const uint32_t parentId) {
+  stackInternInitLocks();
+
+  // the slot is taken from the low bits of the hash, the shard from the high ones
+  const uint64_t hash = stackInternHash(value, parentId);
+  const uint32_t shardIndex = (uint32_t)(hash >> (64 - STACK_INTERN_SHARD_BITS));
+  StackInternShard* shard = &(internShards[shardIndex]);
+
+  omp_set_lock(&(shard->lock));
+
+  // keep the load factor at most 1/2
+  if (2 * (shard->size + 1) > shard->capacity) {
+    stackInternGrow(shard);
+  }
+
+  StackInternEntry* entry =
+      stackInternFindSlot(shard->table, shard->capacity, hash, value, parentId);
+  if (!entry->value) {
+    const uint32_t newId = ++shard->size << STACK_INTERN_SHARD_BITS | shardIndex;
+    *entry = (StackInternEntry){value, parentId, newId};
+  }
+  const uint32_t id = entry->id;
+
+  omp_unset_lock(&(shard->lock));
+
+  return id;
+}
+
+/**
+ * Clears the intern table. Must only be called when no stacks are alive anymore, e.g. after all
+ * graph nodes of a run have been freed, and outside of parallel regions.
+ */
+void stackInternClear(void) {
+  for (uint32_t k = 0; k < STACK_INTERN_N_SHARDS; k++) {
+    free(internShards[k].table);
+    internShards[k].table = NULL;
+    internShards[k].capacity = 0;
+    internShards[k].size = 0;
+  }
+}
+
+/**
+ * Adds a reference to the given stack node.
+ *
+ * @param node The node to reference, may be NULL.
+ */
+static void stackNodeRetain(StackNode* node) {
+  if (node) {
+#pragma omp atomic
+    node->refCount++;
+  }
+}
+
+/**
+ * Drops a reference to the given stack node. Frees the node, and iteratively its successors, if
+ * no references are left.
+ *
+ * @param node The node to release, may be NULL.
+ */
+static void stackNodeRelease(StackNode* node) {
+  while (node) {
+    uint32_t refCount;
+#pragma omp atomic capture
+    refCount = --node->refCount;
+
+    if (refCount > 0) {
+      return;
+    }
+
+    // the node owned the reference to its successor, which now has to be released as well
+    StackNode* next = node->next;
+    memFree(node);
+    node = next;
+  }
+}
+
 /**
  * Pushes a new element onto the stack.
  *
@@ -9,10 +214,13 @@
  * @param value The value to be pushed onto the stack.
  */
 void stackPush(Stack* stack, GraphNode* value) {
-  StackNode* newNode = malloc(sizeof(StackNode));
+  StackNode* newNode = memAlloc(sizeof(StackNode));
 
+  // the new node takes over the reference the stack held on its old top
   newNode->value = value;
   newNode->next = *stack;
+  newNode->refCount = 1;
+  newNode->id = stackIntern(value, stackGetId(*stack));
 
   // update the head of the stack
   *stack = newNode;
@@ -30,10 +238,11 @@ GraphNode* stackPop(Stack* stack) {
 
   GraphNode* result = (*stack)->value;
 
-  // save top node to variable, to be able to free it afterwards
+  // the top node might be shared, so reference the next node before releasing the top node
   StackNode* topNode = *stack;
-  *stack = (*stack)->next;
-  free(topNode);
+  *stack = topNode->next;
+  stackNodeRetain(*stack);
+  stackNodeRelease(topNode);
 
   return result;
 }
@@ -52,15 +261,14 @@ GraphNode* stackTop(const Stack* stack) {
 }
 
 /**
- * This function removes all elements from the stack by repeatedly calling the stackPop function
- * until the stack is empty.
+ * Deletes the stack by dropping its reference to the top node. Nodes that are no longer shared
+ * with other stacks are freed.
  *
  * @param stack Pointer to the stack to be deleted.
  */
 void stackDelete(Stack* stack) {
-  while (*stack != NULL) {
-    stackPop(stack);
-  }
+  stackNodeRelease(*stack);
+  *stack = NULL;
 }
 
 /**
@@ -72,27 +280,16 @@ void stackDelete(Stack* stack) {
 bool stackIsEmpty(const Stack* stack) { return *stack == NULL; }
 
 /**
- * Compares the values of each node in the two stacks to determine if
- * they are equal. The stacks are considered equal if they have the
- * same number of nodes and each corresponding node has the same value.
+ * Checks whether the two stacks are equal, i.e. they have the same number of nodes and each
+ * corresponding node has the same value. Since stacks are interned, this is a single comparison
+ * of their ids.
  *
  * @param stack1 Pointer to the first stack.
  * @param stack2 Pointer to the second stack.
  * @return true if the stacks are equal, false otherwise.
  */
 bool stackEquals(const Stack stack1, const Stack stack2) {
-  StackNode* node1 = stack1;
-  StackNode* node2 = stack2;
-
-  while (node1 != NULL && node2 != NULL) {
-    if (node1->value != node2->value)
-      return false;
-
-    node1 = node1->next;
-    node2 = node2->next;
-  }
-
-  return node1 == NULL && node2 == NULL;
+  return stackGetId(stack1) == stackGetId(stack2);
 }
 
 /**
@@ -115,30 +312,23 @@ void stackPrint(const Stack* stack) {
 }
 
 /**
- * Recursively pushes the values of a linked list backwards onto a stack.
+ * Creates a copy of the given stack. The copy shares all nodes with the original, so this only
+ * takes a new reference to the top node.
  *
- * @param stack The stack to push the values onto.
- * @param node The current node in the linked list.
+ * @param stack The stack to be copied.
+ * @return A new stack that is a copy of the original stack.
  */
-static void pushBackwards(Stack* stack, StackNode* node) {
-  if (!node) {
-    return;
-  }
+Stack stackCopy(const Stack stack) {
+  stackNodeRetain(stack);
 
-  pushBackwards(stack, node->next);
-  stackPush(stack, node->value);
+  return stack;
 }
 
 /**
- * Creates a copy of the given stack.
+ * Returns the interned id of the given stack. Equal stacks have equal ids, the empty stack has
+ * id 0.
  *
- * @param stack The stack to be copied.
- * @return A new stack that is a copy of the original stack.
+ * @param stack The stack to get the id of.
+ * @return The id of the stack.
  */
-Stack stackCopy(const Stack stack) {
-  Stack copy = NULL;
-
-  pushBackwards(&copy, stack);
-
-  return copy;
-}
\ No newline at end of file
+uint32_t stackGetId(const Stack stack) { return stack ? stack->id : 0; }
@@ -3,6 +3,7 @@
 
 #include "graphNode.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef struct GraphNode GraphNode;
 
@@ -10,18 +11,22 @@ typedef struct GraphNode GraphNode;
  * @brief Represents a node in a stack.
  *
  * This struct intervalContains the value of the node and a pointer to the next node in
- * the stack.
+ * the stack. Nodes are immutable once created and shared between all stacks that contain them, so
+ * they are reference counted.
  */
 typedef struct StackNode {
   GraphNode* value;       /** The value of the node. */
   struct StackNode* next; /** Pointer to the next node in the stack. */
+  uint32_t refCount;      /** The number of references (stacks and successor nodes) to the node. */
+  uint32_t id; /** Interned id of the stack starting at this node, equal for equal stacks. */
 } StackNode;
 
 /**
  * @brief Definition of the Stack data structure.
  *
- * The Stack type represents a stack data structure.
- * It is implemented as a pointer to a StackNode.
+ * The Stack type represents a persistent stack data structure.
+ * It is implemented as an owning reference to its top StackNode. Copies share all nodes with the
+ * original, pushing only allocates the new top node.
  */
 typedef StackNode* Stack;
 
@@ -33,5 +38,7 @@ bool stackIsEmpty(const Stack* stack);
 bool stackEquals(const Stack stack1, const Stack stack2);
 void stackPrint(const Stack* stack);
 Stack stackCopy(const Stack stack);
+uint32_t stackGetId(const Stack stack);
+void stackInternClear(void);
 
 #endif // STACK_H
\ No newline at end of file
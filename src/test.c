@@ -17,8 +17,8 @@ static void logFailedYesInstance(IntervalSet* instance) {
     debug_print("[]");
   } else
     for (uint32_t i = 0; i < instance->length; i++) {
-      debug_print("[%d, %d, %d], ", instance->intervals[i].bottom, instance->intervals[i].top,
-                  instance->intervals[i].amount);
+      Interval interval = intervalSetGetInterval(instance, i);
+      debug_print("[%d, %d, %d], ", interval.bottom, interval.top, interval.amount);
     }
 
   debug_print("\n");
@@ -35,8 +35,8 @@ static void logFailedNoInstance(IntervalSet* instance) {
     debug_print("[]");
   } else
     for (uint32_t i = 0; i < instance->length; i++) {
-      debug_print("[%d, %d, %d], ", instance->intervals[i].bottom, instance->intervals[i].top,
-                  instance->intervals[i].amount);
+      Interval interval = intervalSetGetInterval(instance, i);
+      debug_print("[%d, %d, %d], ", interval.bottom, interval.top, interval.amount);
     }
 
   debug_print("\n");
@@ -523,6 +523,236 @@ RunInfo testParallelizedAllFull(const uint32_t nIntervals) {
   return testYes(nIntervals, instanceAllFull, badMemoryAlgorithmParallelized);
 }
 
+/**
+ * Tests the frontier version of the bad memory algorithm on a set of simple yes instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testFrontierSimpleYes(const uint32_t nIntervals) {
+  debug_print("Testing frontier simple yes instance.\n");
+
+  return testYes(nIntervals, instanceSimpleYes, badMemoryAlgorithmFrontier);
+}
+
+/**
+ * Tests the frontier version of the bad memory algorithm on a set of simple no instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testFrontierSimpleNo(const uint32_t nIntervals) {
+  debug_print("Testing frontier simple no instance.\n");
+
+  return testNo(nIntervals, instanceSimpleNo, badMemoryAlgorithmFrontier);
+}
+
+/**
+ * Tests the frontier version of the bad memory algorithm on a set of hard witness instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testFrontierMaxWitnessesYes(const uint32_t nIntervals) {
+  debug_print("Testing frontier max witness yes instance.\n");
+
+  return testYes(nIntervals, instanceMaxWitnessesYes, badMemoryAlgorithmFrontier);
+}
+
+/**
+ * Tests the frontier version of the bad memory algorithm on a set of hard witness no
+ * instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testFrontierMaxWitnessesNo(const uint32_t nIntervals) {
+  debug_print("Testing frontier max witness no instance.\n");
+
+  return testNo(nIntervals, instanceMaxWitnessesNo, badMemoryAlgorithmFrontier);
+}
+
+/**
+ * Tests the frontier version of the bad memory algorithm on a set of witness yes instances
+ * that try to maximize the number of groups built.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testFrontierMaxGroupWitnessesYes(const uint32_t nIntervals) {
+  debug_print("Testing frontier max group witness yes instance.\n");
+
+  return testYes(nIntervals, instanceMaxGroupWitnessesYes, badMemoryAlgorithmFrontier);
+}
+
+/**
+ * Tests the frontier version of the bad memory algorithm on a set of witness no instances that
+ * try to maximize the number of groups built.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testFrontierMaxGroupWitnessesNo(const uint32_t nIntervals) {
+  debug_print("Testing frontier max group witness no instance.\n");
+
+  return testNo(nIntervals, instanceMaxGroupWitnessesNo, badMemoryAlgorithmFrontier);
+}
+
+/**
+ * Tests the frontier version of the bad memory algorithm on a set of hard yes amount version
+ * instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testFrontierHardYesAmountVersion(const uint32_t nIntervals) {
+  debug_print("Testing frontier hard yes amount version instance.\n");
+
+  return testYes(nIntervals, instanceHardYesAmountVersion, badMemoryAlgorithmFrontier);
+}
+
+/**
+ * Tests the frontier version of the bad memory algorithm on a set of hard no amount version
+ * instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testFrontierHardNoAmountVersion(const uint32_t nIntervals) {
+  debug_print("Testing frontier hard no amount version instance.\n");
+
+  return testNo(nIntervals, instanceHardNoAmountVersion, badMemoryAlgorithmFrontier);
+}
+
+/**
+ * Tests the frontier version of the bad memory algorithm on a set of all full instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testFrontierAllFull(const uint32_t nIntervals) {
+  debug_print("Testing frontier all full instance.\n");
+
+  return testYes(nIntervals, instanceAllFull, badMemoryAlgorithmFrontier);
+}
+
+/**
+ * Tests the parallel depth-first variant of the bad memory algorithm on a set of simple yes
+ * instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testDepthFirstParallelSimpleYes(const uint32_t nIntervals) {
+  debug_print("Testing parallel depth-first simple yes instance.\n");
+
+  return testYes(nIntervals, instanceSimpleYes, badMemoryDepthFirstParallel);
+}
+
+/**
+ * Tests the parallel depth-first variant of the bad memory algorithm on a set of simple no
+ * instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testDepthFirstParallelSimpleNo(const uint32_t nIntervals) {
+  debug_print("Testing parallel depth-first simple no instance.\n");
+
+  return testNo(nIntervals, instanceSimpleNo, badMemoryDepthFirstParallel);
+}
+
+/**
+ * Tests the parallel depth-first variant of the bad memory algorithm on a set of hard witness
+ * instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testDepthFirstParallelMaxWitnessesYes(const uint32_t nIntervals) {
+  debug_print("Testing parallel depth-first max witness yes instance.\n");
+
+  return testYes(nIntervals, instanceMaxWitnessesYes, badMemoryDepthFirstParallel);
+}
+
+/**
+ * Tests the parallel depth-first variant of the bad memory algorithm on a set of hard witness no
+ * instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testDepthFirstParallelMaxWitnessesNo(const uint32_t nIntervals) {
+  debug_print("Testing parallel depth-first max witness no instance.\n");
+
+  return testNo(nIntervals, instanceMaxWitnessesNo, badMemoryDepthFirstParallel);
+}
+
+/**
+ * Tests the parallel depth-first variant of the bad memory algorithm on a set of witness yes
+ * instances that try to maximize the number of groups built.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testDepthFirstParallelMaxGroupWitnessesYes(const uint32_t nIntervals) {
+  debug_print("Testing parallel depth-first max group witness yes instance.\n");
+
+  return testYes(nIntervals, instanceMaxGroupWitnessesYes, badMemoryDepthFirstParallel);
+}
+
+/**
+ * Tests the parallel depth-first variant of the bad memory algorithm on a set of witness no
+ * instances that try to maximize the number of groups built.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testDepthFirstParallelMaxGroupWitnessesNo(const uint32_t nIntervals) {
+  debug_print("Testing parallel depth-first max group witness no instance.\n");
+
+  return testNo(nIntervals, instanceMaxGroupWitnessesNo, badMemoryDepthFirstParallel);
+}
+
+/**
+ * Tests the parallel depth-first variant of the bad memory algorithm on a set of hard yes amount
+ * version instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testDepthFirstParallelHardYesAmountVersion(const uint32_t nIntervals) {
+  debug_print("Testing parallel depth-first hard yes amount version instance.\n");
+
+  return testYes(nIntervals, instanceHardYesAmountVersion, badMemoryDepthFirstParallel);
+}
+
+/**
+ * Tests the parallel depth-first variant of the bad memory algorithm on a set of hard no amount
+ * version instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testDepthFirstParallelHardNoAmountVersion(const uint32_t nIntervals) {
+  debug_print("Testing parallel depth-first hard no amount version instance.\n");
+
+  return testNo(nIntervals, instanceHardNoAmountVersion, badMemoryDepthFirstParallel);
+}
+
+/**
+ * Tests the parallel depth-first variant of the bad memory algorithm on a set of all full
+ * instances.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ * @return The RunInfo of the test.
+ */
+RunInfo testDepthFirstParallelAllFull(const uint32_t nIntervals) {
+  debug_print("Testing parallel depth-first all full instance.\n");
+
+  return testYes(nIntervals, instanceAllFull, badMemoryDepthFirstParallel);
+}
+
 /**
  * Runs all tests and logs the time it took to execute each test.
  *
@@ -590,6 +820,41 @@ void testRunAllParallelized(const uint32_t nIntervals) {
   debug_print("All parallelized tests completed.\n");
 }
 
+/**
+ * Runs all tests for the frontier variant and logs the time it took to execute each test.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ */
+void testRunAllFrontier(const uint32_t nIntervals) {
+  // measureTime(nIntervals, testFrontierSimpleYes);
+  // measureTime(nIntervals, testFrontierSimpleNo);
+  measureTime(nIntervals, testFrontierMaxWitnessesYes);
+  measureTime(nIntervals, testFrontierMaxWitnessesNo);
+  measureTime(nIntervals, testFrontierMaxGroupWitnessesYes);
+  measureTime(nIntervals, testFrontierMaxGroupWitnessesNo);
+  measureTime(nIntervals, testFrontierAllFull);
+
+  debug_print("All frontier tests completed.\n");
+}
+
+/**
+ * Runs all tests for the parallel depth-first variant and logs the time it took to execute each
+ * test.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ */
+void testRunAllDepthFirstParallel(const uint32_t nIntervals) {
+  // measureTime(nIntervals, testDepthFirstParallelSimpleYes);
+  // measureTime(nIntervals, testDepthFirstParallelSimpleNo);
+  measureTime(nIntervals, testDepthFirstParallelMaxWitnessesYes);
+  measureTime(nIntervals, testDepthFirstParallelMaxWitnessesNo);
+  measureTime(nIntervals, testDepthFirstParallelMaxGroupWitnessesYes);
+  measureTime(nIntervals, testDepthFirstParallelMaxGroupWitnessesNo);
+  measureTime(nIntervals, testDepthFirstParallelAllFull);
+
+  debug_print("All parallel depth-first tests completed.\n");
+}
+
 /**
  * Runs all algorithms on the same instance nIterations times.
  *
@@ -616,3 +881,74 @@ void testAmountInstances(const uint32_t nIntervals) {
   // measureTime(nIntervals, testDepthFirstHardYesAmountVersion);
   // measureTime(nIntervals, testDepthFirstHardNoAmountVersion);
 }
+
+/**
+ * Runs a breadth first engine on the given instance once with and once without releasing the marks
+ * of finished nodes, and checks that the decision and the number of marked sets agree.
+ *
+ * @param instance The instance to test.
+ * @param solverAlgorithm The breadth first engine to use.
+ * @return True if both runs agree, false otherwise.
+ */
+static bool testReleaseMarksAgrees(IntervalSet* instance,
+                                   RunInfo (*solverAlgorithm)(IntervalSet*)) {
+  const BadMemAlgOptions options = badMemAlgGetOptions();
+
+  // the marked sets are only counted if the metrics are computed
+  BadMemAlgOptions testOptions = options;
+  testOptions.solveOnly = false;
+
+  testOptions.releaseMarks = false;
+  badMemAlgSetOptions(testOptions);
+  RunInfo keptRunInfo = solverAlgorithm(instance);
+
+  testOptions.releaseMarks = true;
+  badMemAlgSetOptions(testOptions);
+  RunInfo releasedRunInfo = solverAlgorithm(instance);
+
+  badMemAlgSetOptions(options);
+
+  const bool agrees = keptRunInfo.solutionFound == releasedRunInfo.solutionFound &&
+                      keptRunInfo.nMarkedSets == releasedRunInfo.nMarkedSets;
+  if (!agrees) {
+    debug_print("%s: releasing the marks changed the result (solution %d vs %d, marked sets %u vs "
+                "%u).\n",
+                keptRunInfo.description, keptRunInfo.solutionFound, releasedRunInfo.solutionFound,
+                keptRunInfo.nMarkedSets, releasedRunInfo.nMarkedSets);
+  }
+
+  return agrees;
+}
+
+/**
+ * Runs the breadth first engines with and without releasing the marks on several instances and
+ * checks that releasing them changes neither the decisions nor the number of marked sets.
+ *
+ * @param nIntervals The number of intervals in each instance.
+ */
+void testReleaseMarks(const uint32_t nIntervals) {
+  InstanceInfo (*instanceGenerators[])(const uint32_t) = {
+      instanceSimpleYes, instanceSimpleNo, instanceMaxGroupWitnessesYes,
+      instanceMaxGroupWitnessesNo};
+  RunInfo (*solverAlgorithms[])(IntervalSet*) = {badMemoryAlgorithm, badMemoryAlgorithmParallelized,
+                                                 badMemoryAlgorithmFrontier};
+  const uint32_t nGenerators = sizeof(instanceGenerators) / sizeof(instanceGenerators[0]);
+  const uint32_t nSolvers = sizeof(solverAlgorithms) / sizeof(solverAlgorithms[0]);
+  uint32_t nFailed = 0;
+
+  instanceInitRandom();
+
+  for (uint32_t g = 0; g < nGenerators; g++) {
+    InstanceInfo instance = instanceGenerators[g](nIntervals);
+
+    for (uint32_t e = 0; e < nSolvers; e++) {
+      nFailed += !testReleaseMarksAgrees(instance.intervalSet, solverAlgorithms[e]);
+    }
+
+    intervalSetDelete(instance.intervalSet);
+    free(instance.metadata);
+  }
+
+  debug_print("All release marks tests completed, %u of %u failed.\n", nFailed,
+              nGenerators * nSolvers);
+}
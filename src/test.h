@@ -32,11 +32,32 @@ RunInfo testParallelizedMaxGroupWitnessesNo(const uint32_t nIntervals);
 RunInfo testParallelizedHardYesAmountVersion(const uint32_t nIntervals);
 RunInfo testParallelizedHardNoAmountVersion(const uint32_t nIntervals);
 RunInfo testParallelizedAllFull(const uint32_t nIntervals);
+RunInfo testFrontierSimpleYes(const uint32_t nIntervals);
+RunInfo testFrontierSimpleNo(const uint32_t nIntervals);
+RunInfo testFrontierMaxWitnessesYes(const uint32_t nIntervals);
+RunInfo testFrontierMaxWitnessesNo(const uint32_t nIntervals);
+RunInfo testFrontierMaxGroupWitnessesYes(const uint32_t nIntervals);
+RunInfo testFrontierMaxGroupWitnessesNo(const uint32_t nIntervals);
+RunInfo testFrontierHardYesAmountVersion(const uint32_t nIntervals);
+RunInfo testFrontierHardNoAmountVersion(const uint32_t nIntervals);
+RunInfo testFrontierAllFull(const uint32_t nIntervals);
+RunInfo testDepthFirstParallelSimpleYes(const uint32_t nIntervals);
+RunInfo testDepthFirstParallelSimpleNo(const uint32_t nIntervals);
+RunInfo testDepthFirstParallelMaxWitnessesYes(const uint32_t nIntervals);
+RunInfo testDepthFirstParallelMaxWitnessesNo(const uint32_t nIntervals);
+RunInfo testDepthFirstParallelMaxGroupWitnessesYes(const uint32_t nIntervals);
+RunInfo testDepthFirstParallelMaxGroupWitnessesNo(const uint32_t nIntervals);
+RunInfo testDepthFirstParallelHardYesAmountVersion(const uint32_t nIntervals);
+RunInfo testDepthFirstParallelHardNoAmountVersion(const uint32_t nIntervals);
+RunInfo testDepthFirstParallelAllFull(const uint32_t nIntervals);
 void testRunAll(const uint32_t nIntervals);
 void testRunYes(const uint32_t nIntervals);
 void testRunAllDepthFirst(const uint32_t nIntervals);
 void testRunAllParallelized(const uint32_t nIntervals);
+void testRunAllFrontier(const uint32_t nIntervals);
+void testRunAllDepthFirstParallel(const uint32_t nIntervals);
 void testSameSimpleInstances(const uint32_t nIntervals, const uint32_t nIterations);
 void testAmountInstances(const uint32_t nIntervals);
+void testReleaseMarks(const uint32_t nIntervals);
 
 #endif // TEST_H